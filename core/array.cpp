@@ -5,19 +5,140 @@
 
 namespace ink {
 
-void Ink_Array::disposeArrayValue()
+/* same as IGC_CHECK_WRITE_BARRIER, but the array is never NULL so it's not tested */
+inline void checkElementBarrier(Ink_InterpreteEngine *engine, Ink_Array *arr, Ink_Object *obj)
+{
+	if (IS_DISPOSABLE(obj) && arr->mark == engine->curBlack()) {
+		SET_GREY(arr);
+	}
+	return;
+}
+
+void Ink_ArrayValue::unshift(Ink_Object *obj)
+{
+	size_type gap;
+
+	if (!head) {
+		/* leave a gap in front as large as the array so the next unshifts are free */
+		gap = size() > INK_ARRAY_MIN_FRONT_GAP ? size() : INK_ARRAY_MIN_FRONT_GAP;
+		elem.insert(elem.begin(), gap, Ink_ArrayElement());
+		head = gap;
+	}
+	elem[--head] = Ink_ArrayElement(obj);
+
+	return;
+}
+
+void Ink_ArrayValue::erase(size_type begin, size_type end)
+{
+	size_type i;
+
+	if (begin >= end) return;
+
+	if (begin) {
+		elem.erase(elem.begin() + head + begin, elem.begin() + head + end);
+		return;
+	}
+
+	/* front removal only moves the head */
+	for (i = head; i < head + end; i++) {
+		elem[i] = Ink_ArrayElement();
+	}
+	head += end;
+
+	if (head == elem.size()) {
+		elem.clear();
+		head = 0;
+	} else if (head > 2 * size() + INK_ARRAY_MIN_FRONT_GAP) {
+		elem.erase(elem.begin(), elem.begin() + head);
+		head = 0;
+	}
+
+	return;
+}
+
+void Ink_Array::pushElement(Ink_Object *obj)
+{
+	value.push(obj);
+	if (obj) {
+		obj->setDebugName("");
+		checkElementBarrier(engine, this, obj);
+	}
+	return;
+}
+
+void Ink_Array::setElement(Ink_ArrayValue::size_type i, Ink_Object *obj)
+{
+	if (value.getSlot(i)) {
+		value.getSlot(i)->setValue(obj);
+		return;
+	}
+
+	value.set(i, obj);
+	if (obj) {
+		obj->setDebugName("");
+		checkElementBarrier(engine, this, obj);
+	}
+	return;
+}
+
+void Ink_Array::unshiftElement(Ink_Object *obj)
+{
+	value.unshift(obj);
+	if (obj) {
+		obj->setDebugName("");
+		checkElementBarrier(engine, this, obj);
+	}
+	return;
+}
+
+Ink_HashTable *Ink_Array::getElementSlot(Ink_ArrayValue::size_type i)
+{
+	Ink_HashTable *ret;
+	Ink_Object *obj;
+
+	if ((ret = value.getSlot(i)) != NULL)
+		return ret;
+
+	obj = value.get(i);
+	value.setSlot(i, ret = new Ink_HashTable(obj ? obj : UNDEFINED, this));
+
+	return ret;
+}
+
+void Ink_Array::removeElement(Ink_ArrayValue::size_type begin, Ink_ArrayValue::size_type end)
+{
+	Ink_ArrayValue::size_type i;
+
+	for (i = begin; i < end; i++) {
+		if (value.getSlot(i))
+			disposeSlot(value.getSlot(i));
+	}
+	value.erase(begin, end);
+
+	return;
+}
+
+void Ink_Array::disposeSlot(Ink_HashTable *slot)
 {
 	Ink_Object *obj;
+
+	if ((obj = engine->getGlobalReturnValue()) != NULL
+		&& obj->address == slot) {
+		obj->address = NULL;
+	}
+	engine->breakUnreachableBonding(slot);
+	delete slot;
+
+	return;
+}
+
+void Ink_Array::disposeArrayValue()
+{
 	Ink_ArrayValue::size_type i;
 	for (i = 0; i < value.size(); i++) {
-		if (value[i]) {
-			if ((obj = engine->getGlobalReturnValue()) != NULL
-				&& obj->address == value[i]) {
-				obj->address = NULL;
-			}
-			engine->breakUnreachableBonding(value[i]);
-			delete value[i];
-		}
+		if (value.getSlot(i))
+			disposeSlot(value.getSlot(i));
 	}
 	return;
 }
@@ -25,9 +146,11 @@ void Ink_Array::disposeArrayValue()
 void Ink_Array::doSelfMark(Ink_InterpreteEngine *engine, IGC_Marker marker)
 {
 	Ink_ArrayValue::size_type i;
+	Ink_Object *obj;
+
 	for (i = 0; i < value.size(); i++) {
-		if (value[i]) {
-			marker(engine, value[i]->getValue());
+		if ((obj = value.get(i)) != NULL) {
+			marker(engine, obj);
 		}
 	}
 	return;
@@ -145,29 +145,28 @@ Ink_Object *Ink_String::cloneDeep(Ink_InterpreteEngine *engine)
 	return new_obj;
 }
 
-Ink_ArrayValue Ink_Array::cloneArrayValue(Ink_ArrayValue val, Ink_Object *parent)
+Ink_ArrayValue Ink_Array::cloneArrayValue(Ink_ArrayValue &val)
 {
 	Ink_ArrayValue ret = Ink_ArrayValue();
 	Ink_ArrayValue::size_type i;
 
+	ret.reserve(val.size());
 	for (i = 0; i < val.size(); i++) {
-		if (val[i])
-			ret.push_back(new Ink_HashTable(val[i]->getValue(), parent));
-		else ret.push_back(NULL);
+		ret.push(val.get(i));
 	}
 
 	return ret;
 }
 
-Ink_ArrayValue Ink_Array::cloneDeepArrayValue(Ink_InterpreteEngine *engine, Ink_ArrayValue val, Ink_Object *parent)
+Ink_ArrayValue Ink_Array::cloneDeepArrayValue(Ink_InterpreteEngine *engine, Ink_ArrayValue &val)
 {
 	Ink_ArrayValue ret = Ink_ArrayValue();
 	Ink_ArrayValue::size_type i;
+	Ink_Object *tmp;
 
+	ret.reserve(val.size());
 	for (i = 0; i < val.size(); i++) {
-		if (val[i] && val[i]->getValue())
-			ret.push_back(new Ink_HashTable(val[i]->getValue()->cloneDeep(engine), parent));
-		else ret.push_back(NULL);
+		ret.push((tmp = val.get(i)) != NULL ? tmp->cloneDeep(engine) : NULL);
 	}
 
 	return ret;
@@ -177,7 +176,7 @@ Ink_Object *Ink_Array::clone(Ink_InterpreteEngine *engine)
 {
 	Ink_Array *new_obj = new Ink_Array(engine);
 
-	new_obj->value = cloneArrayValue(value, new_obj);
+	new_obj->value = cloneArrayValue(value);
 	cloneHashTable(this, new_obj);
 
 	return new_obj;
@@ -191,7 +190,7 @@ Ink_Object *Ink_Array::cloneDeep(Ink_InterpreteEngine *engine)
 	if (!(tmp = engine->cloneDeepHasTraced(this))) {
 		new_obj = new Ink_Array(engine);
 		engine->addDeepCloneTrace(this, new_obj);
-		new_obj->value = cloneDeepArrayValue(engine, value, new_obj);
+		new_obj->value = cloneDeepArrayValue(engine, value);
 		cloneDeepHashTable(engine, this, new_obj);
 	} else return tmp;
 
@@ -40,22 +40,28 @@ void Ink_ContextChain::removeContext(Ink_ContextObject *c, bool if_delete)
 
 	for (i = tail; i; i = i->outer) {
 		if (i->getContext() == c) {
-			if (i->outer)
-				i->outer->inner = i->inner;
-			if (i->inner)
-				i->inner->outer = i->outer;
-			if (i == tail)
-				tail = i->outer;
-			if (i == head)
-				head = i->inner;
-			if (if_delete)
-				delete i;
+			removeSub(i, if_delete);
 			break;
 		}
 	}
 	return;
 }
 
+void Ink_ContextChain::removeSub(Ink_ContextChain_sub *i, bool if_delete)
+{
+	if (i->outer)
+		i->outer->inner = i->inner;
+	if (i->inner)
+		i->inner->outer = i->outer;
+	if (i == tail)
+		tail = i->outer;
+	if (i == head)
+		head = i->inner;
+	if (if_delete)
+		delete i;
+	return;
+}
+
 Ink_ContextObject *Ink_ContextChain::getGlobal()
 {
 	return head ? head->getContext() : NULL;
@@ -75,7 +81,13 @@ Ink_Object *Ink_ContextChain::searchSlot(Ink_InterpreteEngine *engine, const cha
 
 Ink_HashTable *Ink_ContextChain::searchSlotMapping(Ink_InterpreteEngine *engine, const char *slot_id, Ink_ContextObject **found_in)
 {
-	Ink_ContextChain_sub *i = tail;
+	return searchSlotMapping(engine, tail, slot_id, found_in);
+}
+
+Ink_HashTable *Ink_ContextChain::searchSlotMapping(Ink_InterpreteEngine *engine, Ink_ContextChain_sub *from,
+												   const char *slot_id, Ink_ContextObject **found_in)
+{
+	Ink_ContextChain_sub *i = from;
 	Ink_HashTable *ret = NULL;
 
 	while (i && !(ret = i->getContext()->getSlotMapping(engine, slot_id, false /* don't search prototype chain */))) {
@@ -123,6 +135,39 @@ Ink_ContextChain *Ink_ContextChain::copyContextChain()
 	return new_chain;
 }
 
+/* make this chain a copy of the given one with local appended, reusing the nodes */
+Ink_ContextChain *Ink_ContextChain::resetContextChain(Ink_ContextChain *chain, Ink_ContextObject *local)
+{
+	Ink_ContextChain_sub *i, *node = head, *last = NULL, *tmp;
+	Ink_ContextObject *c;
+
+	for (i = chain->head; ; i = i->inner) {
+		c = i ? i->getContext() : local;
+		if (node) {
+			node->context = c;
+		} else {
+			node = new Ink_ContextChain_sub(c);
+			node->outer = last;
+			if (last) last->inner = node;
+			else head = node;
+		}
+		last = node;
+		node = node->inner;
+		if (!i) break;
+	}
+
+	/* dispose nodes left by a deeper chain */
+	last->inner = NULL;
+	tail = last;
+	while (node) {
+		tmp = node;
+		node = node->inner;
+		delete tmp;
+	}
+
+	return this;
+}
+
 Ink_ContextChain *Ink_ContextChain::copyDeepContextChain(Ink_InterpreteEngine *engine)
 {
 	Ink_ContextChain_sub *i;
@@ -1,8 +1,10 @@
 #ifndef _CONTEXT_H_
 #define _CONTEXT_H_
 
+#include <vector>
 #include "object.h"
 #include "general.h"
+#include "gc/collect.h"
 
 namespace ink {
 
@@ -68,12 +70,16 @@ public:
 	Ink_ContextChain_sub *addContext(Ink_ContextObject *c);
 	void removeLast(bool if_delete = true);
 	void removeContext(Ink_ContextObject *c, bool if_delete = true);
+	void removeSub(Ink_ContextChain_sub *i, bool if_delete = true);
 	Ink_ContextObject *getGlobal();
 	Ink_ContextObject *getLocal();
 	Ink_Object *searchSlot(Ink_InterpreteEngine *engine, const char *slot_id); // from local
 	Ink_HashTable *searchSlotMapping(Ink_InterpreteEngine *engine, const char *slot_id,
 									 Ink_ContextObject **found_in = NULL); // from local
+	static Ink_HashTable *searchSlotMapping(Ink_InterpreteEngine *engine, Ink_ContextChain_sub *from,
+											const char *slot_id, Ink_ContextObject **found_in = NULL);
 	Ink_ContextChain *copyContextChain();
+	Ink_ContextChain *resetContextChain(Ink_ContextChain *chain, Ink_ContextObject *local);
 	Ink_ContextChain *copyDeepContextChain(Ink_InterpreteEngine *engine);
 	void doSelfMark(Ink_InterpreteEngine *engine, IGC_Marker marker);
 
@@ -91,6 +97,19 @@ public:
 	}
 };
 
+/* state of a function call, reused by later calls */
+class Ink_CallFrame {
+public:
+	IGC_CollectEngine gc_engine;
+	Ink_ContextChain context;
+
+	Ink_CallFrame(Ink_InterpreteEngine *engine)
+	: gc_engine(engine), context()
+	{ }
+};
+
+typedef std::vector<Ink_CallFrame *> Ink_CallFrameStack;
+
 }
 
 #endif
@@ -10,6 +10,8 @@
 #include "../../includes/universal.h"
 
 #define INKCO_STACK_SIZE (1024 * 1024 * 10)
+#define INKCO_STACK_POOL_MAX (4096) /* max count of free stacks kept for reuse */
+#define INKCO_STACK_RESIDENT_SIZE (1024 * 64) /* top of a pooled stack left resident */
 
 namespace ink {
 
@@ -31,6 +33,8 @@ public:
 typedef std::vector<Ink_CoCall> Ink_CoCallList;
 
 void Ink_initCoroutine();
+void InkCoro_setStackSize(Ink_SizeType size);
+Ink_SizeType InkCoro_getStackSize();
 
 }
 
@@ -58,11 +62,16 @@ struct InkCoro_Routine {
 	InkCoro_Function func;
 	InkCoro_State state;
 
+	void *stack_base; /* including the guard page */
+	Ink_SizeType stack_size;
+
 	InkCoro_Routine()
 	{
 		arg = NULL;
 		func = NULL;
 		state = INKCO_READY;
+		stack_base = NULL;
+		stack_size = 0;
 	}
 };
 
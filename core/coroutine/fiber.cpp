@@ -4,6 +4,20 @@
 
 namespace ink {
 
+/* fibers manage their own stacks, only the size is configurable */
+static Ink_SizeType inkco_stack_size = INKCO_STACK_SIZE;
+
+void InkCoro_setStackSize(Ink_SizeType size)
+{
+	inkco_stack_size = size;
+	return;
+}
+
+Ink_SizeType InkCoro_getStackSize()
+{
+	return inkco_stack_size;
+}
+
 void InkCoro_Scheduler::destroy(InkCoro_Routine *co)
 {
 	InkCoro_RoutinePool::iterator pool_iter;
@@ -27,7 +41,7 @@ int InkCoro_Scheduler::create(InkCoro_Function fp, void *arg)
 {
 	InkCoro_Routine *co = new InkCoro_Routine();
 
-	co->fib = CreateFiber(0, (LPFIBER_START_ROUTINE)wrapper,
+	co->fib = CreateFiber(inkco_stack_size, (LPFIBER_START_ROUTINE)wrapper,
 						  co->tmp_arg = new InkCoro_Scheduler_wrapper_arg(this, co));
 	co->func = fp;
 	co->arg = arg;
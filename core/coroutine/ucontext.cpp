@@ -1,16 +1,129 @@
+#include <errno.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <sys/mman.h>
 #include "coroutine.h"
 
+#ifndef MAP_ANONYMOUS
+	#define MAP_ANONYMOUS MAP_ANON
+#endif
+
+#ifndef MAP_NORESERVE
+	#define MAP_NORESERVE 0
+#endif
+
 namespace ink {
 
-void InkCoro_Scheduler::destroy(InkCoro_Routine *co)
+/* free stacks of all schedulers, each one is mapped with a guard page below it */
+class InkCoro_FreeStack {
+public:
+	void *base;
+	Ink_SizeType size;
+
+	InkCoro_FreeStack(void *base, Ink_SizeType size)
+	: base(base), size(size)
+	{ }
+};
+
+static pthread_mutex_t inkco_stack_pool_lock = PTHREAD_MUTEX_INITIALIZER;
+static std::vector<InkCoro_FreeStack> inkco_stack_pool;
+static Ink_SizeType inkco_stack_size = INKCO_STACK_SIZE;
+
+inline Ink_SizeType InkCoro_getPageSize()
+{
+	static Ink_SizeType page_size = 0;
+
+	if (!page_size) {
+		page_size = sysconf(_SC_PAGESIZE);
+	}
+
+	return page_size;
+}
+
+void InkCoro_setStackSize(Ink_SizeType size)
+{
+	Ink_SizeType page_size = InkCoro_getPageSize();
+
+	pthread_mutex_lock(&inkco_stack_pool_lock);
+	inkco_stack_size = (size + page_size - 1) / page_size * page_size;
+	pthread_mutex_unlock(&inkco_stack_pool_lock);
+
+	return;
+}
+
+Ink_SizeType InkCoro_getStackSize()
+{
+	return inkco_stack_size;
+}
+
+/* return: stack base(guard page included), NULL if failed */
+static void *InkCoro_allocStack(Ink_SizeType &size)
 {
-	InkCoro_RoutinePool::iterator pool_iter;
+	Ink_SizeType page_size = InkCoro_getPageSize();
+	void *ret = NULL;
+
+	pthread_mutex_lock(&inkco_stack_pool_lock);
+	size = inkco_stack_size;
+	while (!inkco_stack_pool.empty()) {
+		InkCoro_FreeStack tmp = inkco_stack_pool.back();
+		inkco_stack_pool.pop_back();
+
+		if (tmp.size == size) {
+			ret = tmp.base;
+			break;
+		}
+		/* stack size changed */
+		munmap(tmp.base, tmp.size + page_size);
+	}
+	pthread_mutex_unlock(&inkco_stack_pool_lock);
+
+	if (ret) return ret;
+
+	ret = mmap(NULL, size + page_size, PROT_READ | PROT_WRITE,
+			   MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+	if (ret == MAP_FAILED) {
+		return NULL;
+	}
+
+	/* stack grows down, overflow hits the guard page */
+	if (mprotect(ret, page_size, PROT_NONE)) {
+		munmap(ret, size + page_size);
+		return NULL;
+	}
+
+	return ret;
+}
+
+static void InkCoro_freeStack(void *base, Ink_SizeType size)
+{
+	Ink_SizeType page_size = InkCoro_getPageSize();
 
-	if ((pool_iter = std::find(pool.begin(), pool.end(), co))
-		!= pool.end()) {
-		(*pool_iter)->state = INKCO_DEAD;
+#ifdef MADV_DONTNEED
+	/* drop the deep pages before pooling, otherwise idle stacks stay resident
+	 * the top is touched by every routine and kept */
+	if (size > INKCO_STACK_RESIDENT_SIZE) {
+		madvise((char *)base + page_size, size - INKCO_STACK_RESIDENT_SIZE, MADV_DONTNEED);
 	}
+#endif
 
+	pthread_mutex_lock(&inkco_stack_pool_lock);
+	if (inkco_stack_pool.size() < INKCO_STACK_POOL_MAX
+		&& size == inkco_stack_size) {
+		inkco_stack_pool.push_back(InkCoro_FreeStack(base, size));
+		base = NULL;
+	}
+	pthread_mutex_unlock(&inkco_stack_pool_lock);
+
+	if (base) {
+		munmap(base, size + page_size);
+	}
+
+	return;
+}
+
+void InkCoro_Scheduler::destroy(InkCoro_Routine *co)
+{
+	co->state = INKCO_DEAD;
 	return;
 }
 
@@ -34,15 +147,17 @@ int InkCoro_Scheduler::create(InkCoro_Function fp, void *arg)
 	co->state = INKCO_READY;
 
 	if ((err_code = getcontext(&co->env)) < 0) {
+		delete co;
 		return err_code;
 	}
 
-	if ((err_code = posix_memalign(&co->env.uc_stack.ss_sp,
-								   8, INKCO_STACK_SIZE)) != 0) {
-		return err_code;
+	if (!(co->stack_base = InkCoro_allocStack(co->stack_size))) {
+		delete co;
+		return ENOMEM;
 	}
 
-	co->env.uc_stack.ss_size = INKCO_STACK_SIZE;
+	co->env.uc_stack.ss_sp = (char *)co->stack_base + InkCoro_getPageSize();
+	co->env.uc_stack.ss_size = co->stack_size;
 	co->env.uc_link = &env;
 
 	uintptr_t ul = (uintptr_t)co;
@@ -86,7 +201,7 @@ void InkCoro_Scheduler::schedule()
 		swapcontext(&env, &pool[current]->env);
 
 		if (pool[current]->state == INKCO_DEAD) {
-			free(pool[current]->env.uc_stack.ss_sp);
+			InkCoro_freeStack(pool[current]->stack_base, pool[current]->stack_size);
 			delete pool[current];
 			pool[current] = NULL;
 		}
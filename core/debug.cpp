@@ -134,8 +134,8 @@ void Ink_InterpreteEngine::printSlotInfo(FILE *fp, Ink_Object *obj, string prefi
 		arr = as<Ink_Array>(obj);
 		for (j = 0; j < arr->value.size(); j++) {
 			fprintf(fp, "%s" DBG_TAB "[%lu]: ", prefix.c_str(), j);
-			if (arr->value[j]) {
-				printDebugInfo(fp, arr->value[j]->getValue(), "", DBG_TAB + prefix);
+			if (!arr->value.isHole(j)) {
+				printDebugInfo(fp, arr->value.get(j), "", DBG_TAB + prefix);
 			} else {
 				fprintf(fp, "(no value)\n");
 			}
@@ -110,8 +110,8 @@ InkWarn_Insert_Non_Function_Object(Ink_InterpreteEngine *engine)
 
 inline void
 InkWarn_Array_Index_Exceed(Ink_InterpreteEngine *engine,
-						   Ink_ArrayValue::size_type index,
-						   Ink_ArrayValue::size_type size)
+						   Ink_SizeType index,
+						   Ink_SizeType size)
 {
 	std::stringstream strm;
 	strm << "Index " << index << " exceed size of the array(" << size << ")";
@@ -586,6 +586,14 @@ InkWarn_Slice_Require_Non_Zero_Range(Ink_InterpreteEngine *engine)
 	return;
 }
 
+inline void
+InkWarn_Array_Changed_While_Sorting(Ink_InterpreteEngine *engine)
+{
+	InkErro_doPrintWarning(engine, INK_EXCODE_WARN_ARRAY_CHANGED_WHILE_SORTING,
+						   "Array resized by the comparator of sort, left unsorted");
+	return;
+}
+
 inline void
 InkNote_Method_Fallthrough(Ink_InterpreteEngine *engine, const char *name, Ink_TypeTag origin, Ink_TypeTag to_type)
 {
@@ -617,8 +625,8 @@ InkNote_Exceed_Argument(Ink_InterpreteEngine *engine)
 
 inline void
 InkNote_Slice_Start_Greater(Ink_InterpreteEngine *engine,
-							Ink_ArrayValue::size_type start,
-							Ink_ArrayValue::size_type end)
+							Ink_SizeType start,
+							Ink_SizeType end)
 {
 	std::stringstream strm;
 	strm << "The first argument "
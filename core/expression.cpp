@@ -47,6 +47,45 @@ namespace ink {
 
 using namespace std;
 
+void Ink_setAddressed(Ink_Expression *exp)
+{
+	Ink_IdentifierExpression *id_exp;
+	Ink_HashExpression *hash_exp;
+	Ink_CallExpression *call_exp;
+	Ink_FunctionExpression *func_exp;
+
+	if ((id_exp = as<Ink_IdentifierExpression>(exp)) != NULL) {
+		id_exp->is_addressed = true;
+	} else if ((hash_exp = as<Ink_HashExpression>(exp)) != NULL) {
+		hash_exp->is_addressed = true;
+		/* the slot may be created on the base */
+		Ink_setAddressed(hash_exp->base);
+	} else if ((call_exp = as<Ink_CallExpression>(exp)) != NULL) {
+		call_exp->is_addressed = true;
+		/* a literal function returns the value of its last expression */
+		if ((func_exp = as<Ink_FunctionExpression>(call_exp->callee)) != NULL
+			&& !func_exp->exp_list.empty()) {
+			Ink_setAddressed(func_exp->exp_list.back());
+		}
+	}
+
+	return;
+}
+
+void Ink_setAssignee(Ink_Expression *lval)
+{
+	Ink_HashExpression *hash_exp;
+
+	if ((hash_exp = as<Ink_HashExpression>(lval)) != NULL) {
+		Ink_setAddressed(hash_exp->base);
+	} else if (as<Ink_CallExpression>(lval)) {
+		/* natives like '[]' have no slot to pass */
+		Ink_setAddressed(lval);
+	}
+
+	return;
+}
+
 Ink_NumericValue Ink_NumericExpression::parseInt(string code, bool is_quite, bool *is_success)
 {
 	Ink_SInt64 ret = 0;
@@ -314,6 +353,7 @@ Ink_Object *Ink_AssignmentExpression::eval(Ink_InterpreteEngine *engine, Ink_Con
 
 	Ink_Object *rval_ret;
 	Ink_Object *lval_ret;
+	Ink_HashTable *address = NULL;
 	Ink_Object **tmp;
 	Ink_Object *ret;
 	Ink_Object *assign_method, *assign_event;
@@ -322,10 +362,13 @@ Ink_Object *Ink_AssignmentExpression::eval(Ink_InterpreteEngine *engine, Ink_Con
 	/* eval right hand side first */
 	CATCH_SIGNAL_RET;
 
-	lval_ret = lval->eval(engine, context_chain, Ink_EvalFlag(true));
+	lval_ret = lval->eval(engine, context_chain, Ink_EvalFlag(true, &address));
 	/* left hand side next */
 	CATCH_SIGNAL_RET;
 
+	if (!engine->isSharedNumeric(lval_ret))
+		address = lval_ret->address;
+
 	if ((assign_event = lval_ret->getSlot(engine, "@assign", false))->type == INK_FUNCTION) {
 		tmp = (Ink_Object **)malloc(sizeof(Ink_Object *));
 		tmp[0] = rval_ret;
@@ -345,12 +388,12 @@ Ink_Object *Ink_AssignmentExpression::eval(Ink_InterpreteEngine *engine, Ink_Con
 		CATCH_SIGNAL_RET;
 
 		return ret;
-	} else if (lval_ret->address) {
-		if (lval_ret->address->getSetter()) { /* if has setter, call it */
+	} else if (address) {
+		if (address->getSetter()) { /* if has setter, call it */
 			tmp = (Ink_Object **)malloc(sizeof(Ink_Object *));
 			tmp[0] = rval_ret;
-			// lval_ret->address->getSetter()->setSlot_c("base", lval_ret);
-			ret = lval_ret->address->getSetter()->call(engine, context_chain, lval_ret, 1, tmp);
+			// address->getSetter()->setSlot_c("base", lval_ret);
+			ret = address->getSetter()->call(engine, context_chain, lval_ret, 1, tmp);
 			// engine->setSignal(INTER_NONE);
 			free(tmp);
 			CATCH_SIGNAL_RET;
@@ -358,7 +401,11 @@ Ink_Object *Ink_AssignmentExpression::eval(Ink_InterpreteEngine *engine, Ink_Con
 		} else {
 			/* no setter, directly assign */
 
-			lval_ret->address->setValue(rval_ret);
+			address->setValue(rval_ret);
+		}
+		if (is_return_lval && flags.address && engine->isSharedNumeric(lval_ret)) {
+			/* e.g. 'a++ = 10' */
+			*flags.address = address;
 		}
 		return is_return_lval ? lval_ret : rval_ret;
 	}
@@ -426,9 +473,9 @@ Ink_Object *Ink_ListExpression::eval(Ink_InterpreteEngine *engine, Ink_ContextCh
 
 	for (i = 0; i < elem_list.size(); i++) {
 		if (elem_list[i])
-			arr_obj->value.push_back(new Ink_HashTable(elem_list[i]->eval(engine, context_chain), arr_obj));
+			arr_obj->pushElement(elem_list[i]->eval(engine, context_chain));
 		else
-			arr_obj->value.push_back(new Ink_HashTable(UNDEFINED, arr_obj));
+			arr_obj->pushElement(UNDEFINED);
 		if (INTER_SIGNAL_RECEIVED) {
 			RESTORE_LINE_NUM;
 			return engine->getInterruptValue();
@@ -457,22 +504,94 @@ Ink_Object *Ink_HashExpression::eval(Ink_InterpreteEngine *engine, Ink_ContextCh
 	CATCH_SIGNAL_RET;
 
 	RESTORE_LINE_NUM;
-	return getSlot(engine, context_chain, base_obj, slot_id->c_str(), flags);
+	flags.is_addressed |= is_addressed;
+	return getSlot(engine, context_chain, base_obj, slot_sym, flags, &cache);
+}
+
+bool Ink_InlineCache::watchChain(Ink_InterpreteEngine *engine, Ink_Object *proto, const char *key, Ink_HashTable *slot)
+{
+	Ink_Object *i;
+	Ink_SizeType depth;
+
+	/* every object before the one holding the slot decides where the lookup stops */
+	for (i = proto, depth = 0; i && depth < INK_INLINE_CACHE_MAX_DEPTH; i = i->getProto(), depth++) {
+		i->is_cache_watched = true;
+		if (i->getSlotMapping(engine, key, false) == slot) {
+			if (slot->getParent())
+				slot->getParent()->is_cache_watched = true;
+			return true;
+		}
+	}
+
+	return false;
+}
+
+Ink_HashTable *Ink_InlineCache::getSlotMapping(Ink_InterpreteEngine *engine, Ink_Object *obj,
+											   const char *key, bool *is_from_proto)
+{
+	Ink_InterpreteEngine *expected = NULL;
+	Ink_HashTable *ret;
+	Ink_Object *proto;
+	Ink_SizeType i;
+
+	if (__atomic_load_n(&owner, __ATOMIC_RELAXED) != engine
+		&& !__atomic_compare_exchange_n(&owner, &expected, engine, false,
+										__ATOMIC_RELAXED, __ATOMIC_RELAXED)) {
+		return obj->getSlotMapping(engine, key, is_from_proto);
+	}
+
+	/* own slots are not cached, they change with almost every assignment */
+	if ((ret = obj->getSlotMapping(engine, key, false)) != NULL) {
+		*is_from_proto = false;
+		return ret;
+	}
+
+	if (!(proto = obj->getProto()) || proto->type == INK_UNDEFINED) {
+		*is_from_proto = false;
+		return NULL;
+	}
+
+	for (i = 0; i < INK_INLINE_CACHE_SIZE; i++) {
+		if (entry[i].proto == proto && entry[i].epoch == engine->slot_epoch) {
+			*is_from_proto = true;
+			return entry[i].slot;
+		}
+	}
+
+	ret = obj->getSlotMapping(engine, key, is_from_proto);
+	if (ret && *is_from_proto && watchChain(engine, proto, key, ret)) {
+		entry[victim].proto = proto;
+		entry[victim].epoch = engine->slot_epoch;
+		entry[victim].slot = ret;
+		victim = (victim + 1) % INK_INLINE_CACHE_SIZE;
+	}
+
+	return ret;
 }
 
 Ink_Object *Ink_HashExpression::getSlot(Ink_InterpreteEngine *engine, Ink_ContextChain *context_chain,
-										Ink_Object *obj, const char *id, Ink_EvalFlag flags)
+										Ink_Object *obj, const char *id, Ink_EvalFlag flags,
+										Ink_InlineCache *cache)
 {
-	Ink_HashTable *hash, *address;
+	Ink_HashTable *hash, *address = NULL;
 	Ink_Object *base = obj, *ret = NULL, *tmp;
 	Ink_Object **argv;
 	bool is_from_proto = false;
 
-	if (!(hash = obj->getSlotMapping(engine, id, &is_from_proto)) /* cannot find slot in the origin object */) {
+	if (flags.is_left_value && engine->isSharedNumeric(obj)) {
+		/* a slot of it is to be assigned, which is never set on a shared numeric */
+		base = obj = engine->getAddressedNumeric(obj, NULL);
+	}
+
+	hash = cache ? cache->getSlotMapping(engine, obj, id, &is_from_proto)
+				 : obj->getSlotMapping(engine, id, &is_from_proto);
+
+	if (!hash /* cannot find slot in the origin object */) {
 		if (obj->type == INK_UNDEFINED) {
 			InkWarn_Get_Slot_Of_Undefined(engine, id);
 		}
-		address = obj->setSlot(id, NULL);
+		if (!engine->isSharedNumeric(obj))
+			address = obj->setSlot(id, NULL);
 
 		if ((tmp = obj->getSlot(engine, "missing"))->type == INK_FUNCTION) {
 			/* has missing method, call it */
@@ -497,18 +616,27 @@ Ink_Object *Ink_HashExpression::getSlot(Ink_InterpreteEngine *engine, Ink_Contex
 
 		if (is_from_proto) {
 			ret = ret->clone(engine);
-			address = obj->setSlot(id, NULL);
+			if (!engine->isSharedNumeric(obj))
+				address = obj->setSlot(id, NULL);
 		} else {
 			address = hash;
 		}
 	}
 
-	/* set address for possible assignment */
-	ret->address = address;
-	/* set base */
-	// ret->setSlot_c("base", base);
-	ret->setBase(base);
-	ret->setDebugName(id);
+	if (flags.address)
+		*flags.address = address;
+
+	if (engine->isSharedNumeric(ret) && flags.is_addressed)
+		ret = engine->getAddressedNumeric(ret, address);
+
+	if (!engine->isSharedNumeric(ret)) {
+		/* set address for possible assignment */
+		ret->address = address;
+		/* set base */
+		// ret->setSlot_c("base", base);
+		ret->setBase(base);
+		ret->setDebugName(id);
+	}
 
 	/* call getter if has one */
 	if (!flags.is_left_value && hash && hash->getGetter()) {
@@ -540,6 +668,12 @@ Ink_Object *Ink_FunctionExpression::eval(Ink_InterpreteEngine *engine, Ink_Conte
 		ret = new Ink_FunctionObject(engine, param, exp_list,
 									 is_macro ? NULL : context_chain->copyContextChain(),
 									 is_inline || is_macro);
+		if (!is_frame_checked) {
+			is_simple_frame = checkSimpleFrame();
+			is_frame_checked = true;
+		}
+		ret->is_simple_frame = is_simple_frame;
+		ret->scope = scope;
 	}
 
 	if (func_attr) {
@@ -554,18 +688,18 @@ Ink_Object *Ink_FunctionExpression::eval(Ink_InterpreteEngine *engine, Ink_Conte
 inline Ink_ArgumentList expandArgument(Ink_InterpreteEngine *engine, Ink_Object *obj)
 {
 	Ink_ArgumentList ret = Ink_ArgumentList();
-	Ink_ArrayValue arr_val;
 	Ink_ArrayValue::size_type i;
+	Ink_Object *tmp;
 
 	if (!obj || obj->type != INK_ARRAY) {
 		InkWarn_With_Attachment_Require(engine);
 		return ret;
 	}
 
-	arr_val = as<Ink_Array>(obj)->value;
+	Ink_ArrayValue &arr_val = as<Ink_Array>(obj)->value;
 
 	for (i = 0; i < arr_val.size(); i++) {
-		ret.push_back(new Ink_Argument(new Ink_ShellExpression(arr_val[i] ? arr_val[i]->getValue() : UNDEFINED)));
+		ret.push_back(new Ink_Argument(new Ink_ShellExpression((tmp = arr_val.get(i)) ? tmp : UNDEFINED)));
 	}
 	return ret;
 }
@@ -576,13 +710,24 @@ Ink_Object *Ink_CallExpression::eval(Ink_InterpreteEngine *engine, Ink_ContextCh
 	Ink_LineNoType line_num_back;
 	SET_LINE_NUM;
 
+	Ink_Object *ret_val;
+	/* eval callee to get parameter declaration */
+	Ink_Object *func = callee->eval(engine, context_chain);
+	CATCH_SIGNAL_RET;
+
+	ret_val = invoke(engine, context_chain, func);
+
+	RESTORE_LINE_NUM;
+
+	return ret_val;
+}
+
+Ink_Object *Ink_CallExpression::invoke(Ink_InterpreteEngine *engine, Ink_ContextChain *context_chain, Ink_Object *func)
+{
 	Ink_ArgumentList::size_type i;
 	Ink_Argument *tmp_arg;
 	Ink_Object **argv = NULL;
 	Ink_Object *ret_val, *expandee;
-	/* eval callee to get parameter declaration */
-	Ink_Object *func = callee->eval(engine, context_chain);
-	CATCH_SIGNAL_RET;
 
 	Ink_ParamList param_list = Ink_ParamList();
 	Ink_ArgumentList dispose_list, tmp_arg_list, another_tmp_arg_list;
@@ -641,6 +786,7 @@ Ink_Object *Ink_CallExpression::eval(Ink_InterpreteEngine *engine, Ink_ContextCh
 							argv[i] = new Ink_Unknown(engine);
 						} else { */
 						Ink_ExpressionList exp_list = Ink_ExpressionList();
+						Ink_setAddressed(tmp_arg_list[i]->arg);
 						exp_list.push_back(tmp_arg_list[i]->arg);
 						argv[i] = new Ink_FunctionObject(engine, Ink_ParamList(), exp_list,
 														 context_chain->copyContextChain(),
@@ -652,6 +798,8 @@ Ink_Object *Ink_CallExpression::eval(Ink_InterpreteEngine *engine, Ink_ContextCh
 						argv[i] = new Ink_Unknown(engine);
 					} else { */
 					Ink_ExpressionList exp_list = Ink_ExpressionList();
+					/* a reference may be assigned to */
+					Ink_setAddressed(tmp_arg_list[i]->arg);
 					exp_list.push_back(tmp_arg_list[i]->arg);
 					argv[i] = new Ink_FunctionObject(engine, Ink_ParamList(), exp_list,
 													 context_chain->copyContextChain(),
@@ -672,6 +820,7 @@ Ink_Object *Ink_CallExpression::eval(Ink_InterpreteEngine *engine, Ink_ContextCh
 
 	argc = tmp_arg_list.size();
 
+	engine->is_addressed_call = is_addressed;
 	ret_val = func->call(engine, context_chain, base_back, argc, argv);
 
 DISPOSE_ARGV:
@@ -682,8 +831,6 @@ DISPOSE_LIST:
 		delete dispose_list[i];
 	}
 
-	RESTORE_LINE_NUM;
-
 	return ret_val;
 }
 
@@ -694,27 +841,72 @@ Ink_Object *Ink_IdentifierExpression::eval(Ink_InterpreteEngine *engine, Ink_Con
 	SET_LINE_NUM;
 
 	Ink_Object *ret;
-	ret = getContextSlot(engine, context_chain, id->c_str(), flags, if_create_slot);
+	ret = lookup(engine, context_chain, flags);
 
 	RESTORE_LINE_NUM;
 	return ret;
 }
 
+Ink_Object *Ink_IdentifierExpression::lookup(Ink_InterpreteEngine *engine, Ink_ContextChain *context_chain, Ink_EvalFlag flags)
+{
+	Ink_ContextChain_sub *sub = context_chain->getTail();
+	Ink_LexicalScope *scope = lex_scope;
+	Ink_ContextObject *context = NULL;
+	Ink_HashTable *hash;
+	Ink_SInt32 depth;
+
+	flags.is_addressed |= is_addressed;
+
+	if (!scope)
+		goto SEARCH;
+
+	/* every context on the way must be a frame of the scope expected,
+	 * and have no slot but the declared ones */
+	for (depth = 0;; depth++) {
+		if (!sub || (context = sub->getContext())->frame_scope != scope)
+			goto SEARCH;
+		if (depth == lex_depth)
+			break;
+		if (context->has_extra_slot)
+			goto SEARCH;
+		sub = sub->outer;
+		scope = scope->outer;
+	}
+
+	if (lex_index >= 0) {
+		/* bonded or not yet set slots are left to the search */
+		hash = context->frame_slot[lex_index];
+		if (hash && (hash->getGetter() || hash->getSetter()
+					 || (hash->hasValue() && !hash->getBonding()))) {
+			return getContextSlot(engine, context_chain, id_sym, flags, if_create_slot, hash, context);
+		}
+	} else if (!context->has_extra_slot) {
+		/* not a local name of any function, skip the frames */
+		if ((hash = Ink_ContextChain::searchSlotMapping(engine, sub->outer, id_sym, &context)) != NULL) {
+			return getContextSlot(engine, context_chain, id_sym, flags, if_create_slot, hash, context);
+		}
+	}
+
+SEARCH:
+	return getContextSlot(engine, context_chain, id_sym, flags, if_create_slot);
+}
+
 Ink_Object *Ink_IdentifierExpression::getContextSlot(Ink_InterpreteEngine *engine, Ink_ContextChain *context_chain, const char *name,
-													 Ink_EvalFlag flags, bool if_create_slot)
+													 Ink_EvalFlag flags, bool if_create_slot,
+													 Ink_HashTable *hash, Ink_ContextObject *base_context)
 {
 	/* Variables */
-	Ink_HashTable *hash, *missing;
+	Ink_HashTable *missing;
 	Ink_ContextObject *local = context_chain->getLocal();
 	// Ink_ContextChain *global = context_chain->getGlobal();
 	Ink_ContextObject *dest_context = local,
-					  *base_context = NULL, *missing_base_context = NULL;
+					  *missing_base_context = NULL;
 	Ink_Object *ret;
 	Ink_Object **argv;
 	wchar_t *tmp_wstr = NULL;
 
-	hash = context_chain->searchSlotMapping(engine, name, &base_context);
-	missing = context_chain->searchSlotMapping(engine, "missing", &missing_base_context);
+	if (!hash)
+		hash = context_chain->searchSlotMapping(engine, name, &base_context);
 
 	/* if the slot cannot be found */
 	if (!hash) {
@@ -725,6 +917,10 @@ Ink_Object *Ink_IdentifierExpression::getContextSlot(Ink_InterpreteEngine *engin
 				ret = new Ink_Object(engine);
 				hash = dest_context->setSlot(name, ret);
 			} else { /* generate a undefined value */
+				/* the handler is only searched for if any context has ever defined one */
+				missing = engine->has_context_missing
+						  ? context_chain->searchSlotMapping(engine, "missing", &missing_base_context)
+						  : NULL;
 				if (missing && missing->getValue()->type == INK_FUNCTION) {
 					argv = (Ink_Object **)malloc(sizeof(Ink_Object *));
 					argv[0] = new Ink_String(engine, name);
@@ -744,17 +940,25 @@ Ink_Object *Ink_IdentifierExpression::getContextSlot(Ink_InterpreteEngine *engin
 			ret = UNDEFINED;
 		}
 	}
-	
-	ret->address = hash; /* set its address for assigning */
+
+	if (flags.address)
+		*flags.address = hash;
+
+	if (engine->isSharedNumeric(ret) && flags.is_addressed)
+		ret = engine->getAddressedNumeric(ret, hash);
+
+	if (!engine->isSharedNumeric(ret)) {
+		ret->address = hash; /* set its address for assigning */
 
 #if 0
-	if (base_context)
-		ret->setBase(base_context);
-	else
+		if (base_context)
+			ret->setBase(base_context);
+		else
 #endif
-	ret->setBase(NULL);
-	
-	ret->setDebugName(name);
+		ret->setBase(NULL);
+
+		ret->setDebugName(name);
+	}
 
 	/* if it's not a left value reference(which will call setter in assign exp) and has getter, call it */
 	if (!flags.is_left_value && hash && hash->getGetter()) {
@@ -785,7 +989,7 @@ Ink_Object *Ink_ArrayLiteral::eval(Ink_InterpreteEngine *engine, Ink_ContextChai
 	Ink_Array *ret = new Ink_Array(engine);
 
 	for (i = 0; i < elem_list.size(); i++) {
-		ret->value.push_back(new Ink_HashTable(elem_list[i]->eval(engine, context_chain), ret));
+		ret->pushElement(elem_list[i]->eval(engine, context_chain));
 		if (INTER_SIGNAL_RECEIVED) {
 			RESTORE_LINE_NUM;
 			return engine->getInterruptValue();
@@ -808,7 +1012,7 @@ Ink_Object *Ink_UndefinedExpression::eval(Ink_InterpreteEngine *engine, Ink_Cont
 
 Ink_Object *Ink_NumericExpression::eval(Ink_InterpreteEngine *engine, Ink_ContextChain *context_chain, Ink_EvalFlag flags)
 {
-	return new Ink_Numeric(engine, value);
+	return engine->getNumeric(value, true);
 }
 
 Ink_Object *Ink_StringExpression::eval(Ink_InterpreteEngine *engine, Ink_ContextChain *context_chain, Ink_EvalFlag flags)
@@ -816,4 +1020,325 @@ Ink_Object *Ink_StringExpression::eval(Ink_InterpreteEngine *engine, Ink_Context
 	return new Ink_String(engine, *value);
 }
 
+inline bool hasIdentifier(Ink_ExpressionList &exp_list, const char **ids)
+{
+	Ink_ExpressionList::size_type i;
+
+	for (i = 0; i < exp_list.size(); i++) {
+		if (exp_list[i] && exp_list[i]->hasIdentifier(ids))
+			return true;
+	}
+
+	return false;
+}
+
+bool Ink_CommaExpression::hasIdentifier(const char **ids)
+{
+	return ink::hasIdentifier(exp_list, ids);
+}
+
+bool Ink_YieldExpression::hasIdentifier(const char **ids)
+{
+	return ret_val && ret_val->hasIdentifier(ids);
+}
+
+bool Ink_InterruptExpression::hasIdentifier(const char **ids)
+{
+	return ret_val && ret_val->hasIdentifier(ids);
+}
+
+bool Ink_LogicExpression::hasIdentifier(const char **ids)
+{
+	return lval->hasIdentifier(ids) || rval->hasIdentifier(ids);
+}
+
+bool Ink_AssignmentExpression::hasIdentifier(const char **ids)
+{
+	return lval->hasIdentifier(ids) || rval->hasIdentifier(ids);
+}
+
+bool Ink_HashTableExpression::hasIdentifier(const char **ids)
+{
+	Ink_HashTableMapping::size_type i;
+
+	for (i = 0; i < mapping.size(); i++) {
+		if ((mapping[i]->key && mapping[i]->key->hasIdentifier(ids))
+			|| mapping[i]->value->hasIdentifier(ids))
+			return true;
+	}
+
+	return false;
+}
+
+bool Ink_ListExpression::hasIdentifier(const char **ids)
+{
+	return ink::hasIdentifier(elem_list, ids);
+}
+
+bool Ink_HashExpression::hasIdentifier(const char **ids)
+{
+	return base->hasIdentifier(ids);
+}
+
+bool Ink_FunctionExpression::hasIdentifier(const char **ids)
+{
+	return ink::hasIdentifier(exp_list, ids);
+}
+
+/* names the body may reach the frame slots by */
+static const char *frame_slot_ids[] = { "base", "this", "self", "let", "eval", "import", NULL };
+
+bool Ink_FunctionExpression::checkSimpleFrame()
+{
+	Ink_ParamList::size_type i, j;
+	const char **id;
+
+	for (i = 0; i < param.size(); i++) {
+		for (id = frame_slot_ids; *id; id++) {
+			if (*param[i].name == *id)
+				return false;
+		}
+		for (j = 0; j < i; j++) {
+			if (*param[i].name == *param[j].name)
+				return false;
+		}
+	}
+
+	return !hasIdentifier(frame_slot_ids);
+}
+
+bool Ink_CallExpression::hasIdentifier(const char **ids)
+{
+	Ink_ArgumentList::size_type i;
+
+	if (callee->hasIdentifier(ids))
+		return true;
+
+	for (i = 0; i < arg_list.size(); i++) {
+		if (!arg_list[i]) continue;
+		if ((arg_list[i]->arg && arg_list[i]->arg->hasIdentifier(ids))
+			|| (arg_list[i]->is_expand && arg_list[i]->expandee->hasIdentifier(ids)))
+			return true;
+	}
+
+	return false;
+}
+
+bool Ink_IdentifierExpression::hasIdentifier(const char **ids)
+{
+	for (; *ids; ids++) {
+		if (*id == *ids)
+			return true;
+	}
+
+	return false;
+}
+
+bool Ink_ArrayLiteral::hasIdentifier(const char **ids)
+{
+	return ink::hasIdentifier(elem_list, ids);
+}
+
+/* frame slots & special slots, always searched by name */
+static const char *unresolved_ids[] = { "base", "this", "self", "let", "prototype", NULL };
+
+static inline bool isResolvable(const char *name)
+{
+	const char **id;
+
+	for (id = unresolved_ids; *id; id++) {
+		if (!strcmp(name, *id))
+			return false;
+	}
+
+	return true;
+}
+
+static inline void declareName(Ink_LexicalScope *scope, const char *name)
+{
+	if (scope && isResolvable(name))
+		scope->declare(name);
+	return;
+}
+
+static inline bool isDeclaredOuter(Ink_LexicalScope *scope, const char *name)
+{
+	for (scope = scope->outer; scope; scope = scope->outer) {
+		if (scope->find(name) >= 0)
+			return true;
+	}
+
+	return false;
+}
+
+inline void resolve(Ink_ExpressionList &exp_list, Ink_LexicalScope *scope, bool is_declaring)
+{
+	Ink_ExpressionList::size_type i;
+
+	for (i = 0; i < exp_list.size(); i++) {
+		if (exp_list[i])
+			exp_list[i]->resolve(scope, is_declaring);
+	}
+
+	return;
+}
+
+void Ink_resolveExpressionList(Ink_ExpressionList &exp_list)
+{
+	resolve(exp_list, NULL, false);
+	return;
+}
+
+void Ink_CommaExpression::resolve(Ink_LexicalScope *scope, bool is_declaring)
+{
+	ink::resolve(exp_list, scope, is_declaring);
+	return;
+}
+
+void Ink_YieldExpression::resolve(Ink_LexicalScope *scope, bool is_declaring)
+{
+	if (ret_val) ret_val->resolve(scope, is_declaring);
+	return;
+}
+
+void Ink_InterruptExpression::resolve(Ink_LexicalScope *scope, bool is_declaring)
+{
+	if (ret_val) ret_val->resolve(scope, is_declaring);
+	return;
+}
+
+void Ink_LogicExpression::resolve(Ink_LexicalScope *scope, bool is_declaring)
+{
+	lval->resolve(scope, is_declaring);
+	rval->resolve(scope, is_declaring);
+	return;
+}
+
+void Ink_AssignmentExpression::resolve(Ink_LexicalScope *scope, bool is_declaring)
+{
+	Ink_IdentifierExpression *id_exp;
+	Ink_HashExpression *hash_exp;
+
+	/* assigning to a name not found creates it in the local context,
+	 * names of the outer scopes are most likely to be found there */
+	if (is_declaring && scope) {
+		if ((id_exp = as<Ink_IdentifierExpression>(lval)) != NULL) {
+			if (!isDeclaredOuter(scope, id_exp->id_sym))
+				declareName(scope, id_exp->id_sym);
+		} else if ((hash_exp = as<Ink_HashExpression>(lval)) != NULL
+				   && (id_exp = as<Ink_IdentifierExpression>(hash_exp->base)) != NULL
+				   && !strcmp(id_exp->id_sym, "let")) {
+			declareName(scope, hash_exp->slot_sym);
+		}
+	}
+
+	lval->resolve(scope, is_declaring);
+	rval->resolve(scope, is_declaring);
+
+	return;
+}
+
+void Ink_HashTableExpression::resolve(Ink_LexicalScope *scope, bool is_declaring)
+{
+	Ink_HashTableMapping::size_type i;
+
+	for (i = 0; i < mapping.size(); i++) {
+		if (mapping[i]->key)
+			mapping[i]->key->resolve(scope, is_declaring);
+		mapping[i]->value->resolve(scope, is_declaring);
+	}
+
+	return;
+}
+
+void Ink_ListExpression::resolve(Ink_LexicalScope *scope, bool is_declaring)
+{
+	ink::resolve(elem_list, scope, is_declaring);
+	return;
+}
+
+void Ink_HashExpression::resolve(Ink_LexicalScope *scope, bool is_declaring)
+{
+	base->resolve(scope, is_declaring);
+	return;
+}
+
+void Ink_FunctionExpression::resolve(Ink_LexicalScope *outer, bool is_declaring)
+{
+	Ink_ParamList::size_type i;
+
+	/* names of the body belong to its own scope */
+	if (is_declaring)
+		return;
+
+	if (is_macro || protocol_name) {
+		/* the body may run in a context chain other than the closure */
+		ink::resolve(exp_list, NULL, false);
+		return;
+	}
+
+	delete scope;
+	scope = new Ink_LexicalScope(outer);
+
+	for (i = 0; i < param.size(); i++) {
+		declareName(scope, param[i].name->c_str());
+	}
+
+	ink::resolve(exp_list, scope, true);
+	ink::resolve(exp_list, scope, false);
+
+	return;
+}
+
+void Ink_CallExpression::resolve(Ink_LexicalScope *scope, bool is_declaring)
+{
+	Ink_ArgumentList::size_type i;
+
+	callee->resolve(scope, is_declaring);
+
+	for (i = 0; i < arg_list.size(); i++) {
+		if (!arg_list[i]) continue;
+		if (arg_list[i]->arg)
+			arg_list[i]->arg->resolve(scope, is_declaring);
+		if (arg_list[i]->is_expand)
+			arg_list[i]->expandee->resolve(scope, is_declaring);
+	}
+
+	return;
+}
+
+void Ink_IdentifierExpression::resolve(Ink_LexicalScope *scope, bool is_declaring)
+{
+	Ink_LexicalScope *i;
+	Ink_SInt32 depth, index;
+
+	if (is_declaring || !scope || !isResolvable(id_sym))
+		return;
+
+	for (i = scope, depth = 0; i; i = i->outer, depth++) {
+		if ((index = i->findSymbol(id_sym)) >= 0) {
+			/* names out of the frame slots are searched by name */
+			if (index < INK_FRAME_SLOT_COUNT) {
+				lex_scope = scope;
+				lex_depth = depth;
+				lex_index = index;
+			}
+			return;
+		}
+	}
+
+	/* not declared by any enclosing function */
+	lex_scope = scope;
+	lex_depth = depth - 1;
+	lex_index = -1;
+
+	return;
+}
+
+void Ink_ArrayLiteral::resolve(Ink_LexicalScope *scope, bool is_declaring)
+{
+	ink::resolve(elem_list, scope, is_declaring);
+	return;
+}
+
 }
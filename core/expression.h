@@ -2,20 +2,67 @@
 #define _EXPRESSION_H_
 
 #include <vector>
+#include <string.h>
 #include "type.h"
 #include "general.h"
+#include "symbol.h"
 
 namespace ink {
 
 class Ink_Expression;
 class Ink_ContextChain;
+class Ink_ContextObject;
+
+/* names a function declares in its local context(parameters & assigned identifiers),
+ * the first INK_FRAME_SLOT_COUNT of them are kept in the frame slots of the context */
+class Ink_LexicalScope {
+public:
+	Ink_LexicalScope *outer;
+	std::vector<const char *> name; /* interned */
+
+	Ink_LexicalScope(Ink_LexicalScope *outer)
+	: outer(outer), name(std::vector<const char *>())
+	{ }
+
+	/* sym: interned name, names are only compared by address
+	 * return: index of the name, -1 if not declared */
+	inline Ink_SInt32 findSymbol(const char *sym)
+	{
+		std::vector<const char *>::size_type i;
+
+		for (i = 0; i < name.size(); i++) {
+			if (name[i] == sym)
+				return i;
+		}
+
+		return -1;
+	}
+
+	inline Ink_SInt32 find(const char *key)
+	{
+		const char *sym = InkSymbol_find(key);
+		return sym ? findSymbol(sym) : -1;
+	}
+
+	inline void declare(const char *key)
+	{
+		if (find(key) < 0)
+			name.push_back(InkSymbol_intern(key));
+		return;
+	}
+};
 
 class Ink_EvalFlag {
 public:
 	bool is_left_value;
-
-	Ink_EvalFlag(bool is_left_value = false)
-	: is_left_value(is_left_value)
+	/* the value has to carry its address itself, see Ink_setAddressed */
+	bool is_addressed;
+	/* if not NULL, set to the slot the value is got from
+	 * shared numerics never carry an address, so an assignment gets it here */
+	Ink_HashTable **address;
+
+	Ink_EvalFlag(bool is_left_value = false, Ink_HashTable **address = NULL)
+	: is_left_value(is_left_value), is_addressed(false), address(address)
 	{ }
 };
 
@@ -32,6 +79,10 @@ public:
 	virtual Ink_Object *eval(Ink_InterpreteEngine *engine, Ink_ContextChain *context_chain) { return eval(engine, context_chain, Ink_EvalFlag()); }
 	virtual Ink_Object *eval(Ink_InterpreteEngine *engine, Ink_ContextChain *context_chain, Ink_EvalFlag flags) { return NULL; }
 	virtual Ink_Expression *clone() { return NULL; }
+	/* if any identifier in ids(NULL terminated) is used in the expression */
+	virtual bool hasIdentifier(const char **ids) { return false; }
+	/* declare(is_declaring) or bind the local names of the function scope, see Ink_LexicalScope */
+	virtual void resolve(Ink_LexicalScope *scope, bool is_declaring) { }
 	virtual ~Ink_Expression()
 	{
 		if (file_name_p)
@@ -39,6 +90,12 @@ public:
 	}
 };
 
+/* the value of exp(an identifier, a slot or a call) has to carry its address,
+ * e.g. the base of '->' */
+void Ink_setAddressed(Ink_Expression *exp);
+/* the same for the left hand side of an assignment, whose own slot is passed by Ink_EvalFlag */
+void Ink_setAssignee(Ink_Expression *lval);
+
 class Ink_ShellExpression: public Ink_Expression {
 public:
 	Ink_Object *obj;
@@ -60,6 +117,8 @@ public:
 	{ }
 
 	virtual Ink_Object *eval(Ink_InterpreteEngine *engine, Ink_ContextChain *context_chain, Ink_EvalFlag flags);
+	virtual bool hasIdentifier(const char **ids);
+	virtual void resolve(Ink_LexicalScope *scope, bool is_declaring);
 
 	virtual ~Ink_CommaExpression()
 	{
@@ -79,6 +138,8 @@ public:
 	{ }
 
 	virtual Ink_Object *eval(Ink_InterpreteEngine *engine, Ink_ContextChain *context_chain, Ink_EvalFlag flags);
+	virtual bool hasIdentifier(const char **ids);
+	virtual void resolve(Ink_LexicalScope *scope, bool is_declaring);
 
 	~Ink_YieldExpression()
 	{
@@ -101,6 +162,8 @@ public:
 	{ }
 
 	virtual Ink_Object *eval(Ink_InterpreteEngine *engine, Ink_ContextChain *context_chain, Ink_EvalFlag flags);
+	virtual bool hasIdentifier(const char **ids);
+	virtual void resolve(Ink_LexicalScope *scope, bool is_declaring);
 
 	~Ink_InterruptExpression()
 	{
@@ -131,6 +194,8 @@ public:
 	{ }
 
 	virtual Ink_Object *eval(Ink_InterpreteEngine *engine, Ink_ContextChain *context_chain, Ink_EvalFlag flags);
+	virtual bool hasIdentifier(const char **ids);
+	virtual void resolve(Ink_LexicalScope *scope, bool is_declaring);
 
 	virtual ~Ink_LogicExpression()
 	{
@@ -150,9 +215,13 @@ public:
 	Ink_AssignmentExpression(Ink_Expression *lval, Ink_Expression *rval,
 							 bool is_return_lval = false, bool is_dispose_lval = true)
 	: lval(lval), rval(rval), is_return_lval(is_return_lval), is_dispose_lval(is_dispose_lval)
-	{ }
+	{
+		Ink_setAssignee(lval);
+	}
 
 	virtual Ink_Object *eval(Ink_InterpreteEngine *engine, Ink_ContextChain *context_chain, Ink_EvalFlag flags);
+	virtual bool hasIdentifier(const char **ids);
+	virtual void resolve(Ink_LexicalScope *scope, bool is_declaring);
 
 	virtual ~Ink_AssignmentExpression()
 	{
@@ -198,6 +267,8 @@ public:
 	{ }
 
 	virtual Ink_Object *eval(Ink_InterpreteEngine *engine, Ink_ContextChain *context_chain, Ink_EvalFlag flags);
+	virtual bool hasIdentifier(const char **ids);
+	virtual void resolve(Ink_LexicalScope *scope, bool is_declaring);
 
 	~Ink_HashTableExpression()
 	{
@@ -217,6 +288,8 @@ public:
 	{ }
 
 	virtual Ink_Object *eval(Ink_InterpreteEngine *engine, Ink_ContextChain *context_chain, Ink_EvalFlag flags);
+	virtual bool hasIdentifier(const char **ids);
+	virtual void resolve(Ink_LexicalScope *scope, bool is_declaring);
 
 	virtual ~Ink_ListExpression()
 	{
@@ -227,17 +300,57 @@ public:
 	}
 };
 
+#define INK_INLINE_CACHE_SIZE 4
+#define INK_INLINE_CACHE_MAX_DEPTH 64
+
+/* polymorphic cache of slots found on the prototype chain, keyed on the prototype of the receiver
+ * entries are valid while the slot epoch of the owner engine stays the same */
+class Ink_InlineCache {
+	struct Entry {
+		Ink_Object *proto;
+		Ink_UInt64 epoch;
+		Ink_HashTable *slot;
+	};
+
+	/* expressions may be shared by actors, only the first engine uses the cache */
+	Ink_InterpreteEngine *owner;
+	Entry entry[INK_INLINE_CACHE_SIZE];
+	Ink_SizeType victim;
+
+	bool watchChain(Ink_InterpreteEngine *engine, Ink_Object *proto, const char *key, Ink_HashTable *slot);
+
+public:
+	Ink_InlineCache()
+	: owner(NULL), victim(0)
+	{
+		memset(entry, 0, sizeof(entry));
+	}
+
+	Ink_HashTable *getSlotMapping(Ink_InterpreteEngine *engine, Ink_Object *obj,
+								  const char *key, bool *is_from_proto);
+};
+
 class Ink_HashExpression: public Ink_Expression {
 public:
 	Ink_Expression *base;
 	std::string *slot_id;
+	const char *slot_sym; /* interned slot_id */
 	bool if_dispose_base;
+	bool is_addressed;
+	Ink_InlineCache cache;
 
 	Ink_HashExpression(Ink_Expression *base, std::string *slot_id, bool if_dispose_base = true)
-	: base(base), slot_id(slot_id), if_dispose_base(if_dispose_base)
-	{ }
+	: base(base), slot_id(slot_id), slot_sym(InkSymbol_intern(slot_id->c_str())),
+	  if_dispose_base(if_dispose_base), is_addressed(false), cache(Ink_InlineCache())
+	{
+		/* these methods work on the slot of their base */
+		if (*slot_id == "->" || *slot_id == "!!" || *slot_id == "delete" || *slot_id == "fix")
+			Ink_setAddressed(base);
+	}
 
 	virtual Ink_Object *eval(Ink_InterpreteEngine *engine, Ink_ContextChain *context_chain, Ink_EvalFlag flags);
+	virtual bool hasIdentifier(const char **ids);
+	virtual void resolve(Ink_LexicalScope *scope, bool is_declaring);
 
 	static Ink_Object *getSlot(Ink_InterpreteEngine *engine, Ink_ContextChain *context_chain, Ink_Object *obj,
 							   const char *id)
@@ -245,7 +358,8 @@ public:
 		return getSlot(engine, context_chain, obj, id, Ink_EvalFlag());
 	}
 	static Ink_Object *getSlot(Ink_InterpreteEngine *engine, Ink_ContextChain *context_chain,
-							   Ink_Object *obj, const char *id, Ink_EvalFlag flags);
+							   Ink_Object *obj, const char *id, Ink_EvalFlag flags,
+							   Ink_InlineCache *cache = NULL);
 
 	virtual ~Ink_HashExpression()
 	{
@@ -264,29 +378,38 @@ public:
 	std::string *protocol_name;
 	Ink_FunctionAttribution *func_attr;
 
+	/* no frame slot(base, this, self, let) is used and parameters are distinct */
+	bool is_frame_checked;
+	bool is_simple_frame;
+
+	Ink_LexicalScope *scope; /* NULL for macros & protocols */
+
 	Ink_FunctionExpression(Ink_ParamList param, Ink_ExpressionList exp_list, bool is_inline = false, bool is_macro = false)
 	: param(param), exp_list(exp_list), is_inline(is_inline), is_macro(is_macro), protocol_name(NULL),
-	  func_attr(NULL)
+	  func_attr(NULL), is_frame_checked(false), is_simple_frame(false), scope(NULL)
 	{ }
 
 	Ink_FunctionExpression(Ink_ParamList param, Ink_ExpressionList exp_list,
 						   Ink_FunctionAttribution *func_attr, bool is_inline = false, bool is_macro = false)
 	: param(param), exp_list(exp_list), is_inline(is_inline), is_macro(is_macro), protocol_name(NULL),
-	  func_attr(func_attr)
+	  func_attr(func_attr), is_frame_checked(false), is_simple_frame(false), scope(NULL)
 	{ }
 
 	Ink_FunctionExpression(Ink_ParamList param, Ink_ExpressionList exp_list, std::string *protocol_name)
 	: param(param), exp_list(exp_list), is_inline(false), is_macro(false), protocol_name(protocol_name),
-	  func_attr(NULL)
+	  func_attr(NULL), is_frame_checked(false), is_simple_frame(false), scope(NULL)
 	{ }
 
 	Ink_FunctionExpression(Ink_ParamList param, Ink_ExpressionList exp_list,
 						   Ink_FunctionAttribution *func_attr, std::string *protocol_name)
 	: param(param), exp_list(exp_list), is_inline(false), is_macro(false), protocol_name(protocol_name),
-	  func_attr(func_attr)
+	  func_attr(func_attr), is_frame_checked(false), is_simple_frame(false), scope(NULL)
 	{ }
 
 	virtual Ink_Object *eval(Ink_InterpreteEngine *engine, Ink_ContextChain *context_chain, Ink_EvalFlag flags);
+	virtual bool hasIdentifier(const char **ids);
+	virtual void resolve(Ink_LexicalScope *scope, bool is_declaring);
+	bool checkSimpleFrame();
 
 	virtual ~Ink_FunctionExpression()
 	{
@@ -301,6 +424,7 @@ public:
 
 		delete protocol_name;
 		delete func_attr;
+		delete scope;
 	}
 };
 
@@ -309,12 +433,17 @@ public:
 	Ink_Expression *callee;
 	Ink_ArgumentList arg_list;
 	bool is_new;
+	bool is_addressed;
 
 	Ink_CallExpression(Ink_Expression *callee, Ink_ArgumentList arg_list, bool is_new = false)
-	: callee(callee), arg_list(arg_list), is_new(is_new)
+	: callee(callee), arg_list(arg_list), is_new(is_new), is_addressed(false)
 	{ }
 
 	virtual Ink_Object *eval(Ink_InterpreteEngine *engine, Ink_ContextChain *context_chain, Ink_EvalFlag flags);
+	virtual bool hasIdentifier(const char **ids);
+	virtual void resolve(Ink_LexicalScope *scope, bool is_declaring);
+	/* eval arguments and call the evaluated callee */
+	Ink_Object *invoke(Ink_InterpreteEngine *engine, Ink_ContextChain *context_chain, Ink_Object *func);
 
 	virtual ~Ink_CallExpression()
 	{
@@ -330,15 +459,30 @@ public:
 class Ink_IdentifierExpression: public Ink_Expression {
 public:
 	std::string *id;
+	const char *id_sym; /* interned id */
 	bool if_create_slot;
+	bool is_addressed;
+
+	/* address resolved at parse time: frame slot lex_index of the context lex_depth levels out,
+	 * or the part of the chain outside all functions if lex_index is -1 */
+	Ink_LexicalScope *lex_scope;
+	Ink_SInt32 lex_depth;
+	Ink_SInt32 lex_index;
 
 	Ink_IdentifierExpression(std::string *id, bool if_create_slot = false)
-	: id(id), if_create_slot(if_create_slot)
+	: id(id), id_sym(InkSymbol_intern(id->c_str())), if_create_slot(if_create_slot),
+	  is_addressed(false), lex_scope(NULL), lex_depth(0), lex_index(-1)
 	{ }
 
 	virtual Ink_Object *eval(Ink_InterpreteEngine *engine, Ink_ContextChain *context_chain, Ink_EvalFlag flags);
+	virtual bool hasIdentifier(const char **ids);
+	virtual void resolve(Ink_LexicalScope *scope, bool is_declaring);
+	/* get the slot by the resolved address if it's still valid in the chain */
+	Ink_Object *lookup(Ink_InterpreteEngine *engine, Ink_ContextChain *context_chain, Ink_EvalFlag flags);
+	/* hash & base_context: the slot already found */
 	static Ink_Object *getContextSlot(Ink_InterpreteEngine *engine, Ink_ContextChain *context_chain,
-									  const char *name, Ink_EvalFlag flags, bool if_create_slot);
+									  const char *name, Ink_EvalFlag flags, bool if_create_slot,
+									  Ink_HashTable *hash = NULL, Ink_ContextObject *base_context = NULL);
 
 	virtual ~Ink_IdentifierExpression()
 	{
@@ -402,6 +546,8 @@ public:
 	{ }
 
 	virtual Ink_Object *eval(Ink_InterpreteEngine *engine, Ink_ContextChain *context_chain, Ink_EvalFlag flags);
+	virtual bool hasIdentifier(const char **ids);
+	virtual void resolve(Ink_LexicalScope *scope, bool is_declaring);
 
 	virtual ~Ink_ArrayLiteral()
 	{
@@ -412,6 +558,9 @@ public:
 	}
 };
 
+/* bind the identifiers of the functions in the top level expressions */
+void Ink_resolveExpressionList(Ink_ExpressionList &exp_list);
+
 }
 
 #endif
@@ -193,9 +193,11 @@ Ink_Object *Ink_FunctionObject::call(Ink_InterpreteEngine *engine, Ink_ContextCh
 	Ink_Object *ret_val = NULL, *pa_ret = NULL;
 	Ink_Array *var_arg = NULL;
 	IGC_CollectEngine *gc_engine_backup = engine->getCurrentGC();
-#if 1
-	char *this_debug_name_back = getDebugName() ? strdup(getDebugName()) : NULL;
-#endif
+	IGC_CollectEngine *gc_engine;
+	Ink_CallFrame *frame;
+	Ink_ContextChain_sub *trace_sub = NULL;
+	const char *this_debug_name_back;
+	bool this_debug_name_owned_back;
 
 	bool force_return = false;
 	bool if_delete_argv = false;
@@ -203,6 +205,9 @@ Ink_Object *Ink_FunctionObject::call(Ink_InterpreteEngine *engine, Ink_ContextCh
 	/* if not inline function, set local context */
 	bool if_set_sp_ptr = !is_inline;
 
+	/* frame slots are only set if they may be used */
+	bool if_set_frame_slot = !is_simple_frame || is_native || this_p;
+
 #if 1
 	ret_val = triggerCallEvent(engine, context, argc, argv);
 	if (engine->getSignal() != INTER_NONE) {
@@ -216,7 +221,6 @@ Ink_Object *Ink_FunctionObject::call(Ink_InterpreteEngine *engine, Ink_ContextCh
 			} else {
 				ret_val = engine->getInterruptValue();
 			}
-			free(this_debug_name_back);
 			return ret_val ? ret_val : NULL_OBJ;
 		}
 	}
@@ -229,30 +233,39 @@ Ink_Object *Ink_FunctionObject::call(Ink_InterpreteEngine *engine, Ink_ContextCh
 		if (if_delete_argv)
 			free(argv);
 
-		free(this_debug_name_back);
 		return pa_ret;
 	}
 #endif
 
-	/* init GC engine */
-	IGC_CollectEngine *gc_engine = new IGC_CollectEngine(engine);
+	/* GC engine is taken from a free frame */
+	frame = engine->allocFrame();
+	gc_engine = &frame->gc_engine;
 	engine->setCurrentGC(gc_engine);
 
-	if (closure_context) {
-		context = closure_context->copyContextChain(); /* copy closure context chain */
-	} else {
-		context = context->copyContextChain();
-	}
-
-	/* create new local context */
 	if (is_ref) {
+		if (closure_context) {
+			context = closure_context->copyContextChain(); /* copy closure context chain */
+		} else {
+			context = context->copyContextChain();
+		}
+
 		local = context->getLocal();
 	} else {
+		/* context chain of the frame is reused */
+
+		/* create new local context */
 		local = new Ink_ContextObject(engine);
-		context->addContext(local);
+		local->setFrameScope(scope);
+		context = frame->context.resetContextChain(closure_context ? closure_context : context, local);
 	}
 
-	if (!is_ref) {
+	if (!is_ref && if_set_frame_slot) {
+		/* keep the debug name from being changed by the slots below */
+		this_debug_name_back = debug_name;
+		this_debug_name_owned_back = is_debug_name_owned;
+		debug_name = NULL;
+		is_debug_name_owned = false;
+
 		if (if_set_sp_ptr) {
 			// local->setSlot_c("base", getSlot(engine, "base"));
 			local->setSlot_c("base", base);
@@ -267,16 +280,19 @@ Ink_Object *Ink_FunctionObject::call(Ink_InterpreteEngine *engine, Ink_ContextCh
 		/* set "this" pointer if exists */
 		if (this_p)
 			local->setSlot_c("this", this_p);
+
+		setDebugName(NULL);
+		debug_name = this_debug_name_back;
+		is_debug_name_owned = this_debug_name_owned_back;
+	} else if (!is_ref) {
+		local->setFrame(base, this);
 	}
 
 #if 1
-	setDebugName(this_debug_name_back);
-	free(this_debug_name_back);
-
 	/* set trace(unsed for mark&sweep GC) and set debug info */
 	if (!is_ref) {
-		engine->addTrace(local)->setDebug(engine->current_file_name,
-										  engine->current_line_number, this);
+		(trace_sub = engine->addTrace(local))->setDebug(engine->current_file_name,
+														engine->current_line_number, this);
 	}
 #endif
 	/* set local context */
@@ -299,9 +315,10 @@ Ink_Object *Ink_FunctionObject::call(Ink_InterpreteEngine *engine, Ink_ContextCh
 			if (param[j].is_variant) { /* find variant argument -- break the loop */
 				break;
 			}
+			/* the local is empty in a simple frame, bind without searching */
 			local->setSlot(param[j].name->c_str(),
 						   argi < argc ? argv[argi]
-						   			   : UNDEFINED); // initiate local argument
+						   			   : UNDEFINED, if_set_frame_slot); // initiate local argument
 		}
 
 		if (j < param.size() && param[j].is_variant) {
@@ -311,7 +328,7 @@ Ink_Object *Ink_FunctionObject::call(Ink_InterpreteEngine *engine, Ink_ContextCh
 			var_arg = new Ink_Array(engine);
 			for (; argi < argc; argi++) {
 				/* push arguments in to VA array */
-				var_arg->value.push_back(new Ink_HashTable(argv[argi], var_arg));
+				var_arg->pushElement(argv[argi]);
 			}
 
 			/* set VA array */
@@ -364,10 +381,10 @@ SIGINT_END:
 	if (if_delete_argv)
 		free(argv);
 
-	/* remove local context from chain and trace(if not reference) */
-	if (!is_ref) {
-		context->removeLast();
-		engine->removeTrace(local);
+	/* remove local context from trace(if not reference)
+	 * by its own node, suspended coroutines may have pushed theirs after it */
+	if (trace_sub) {
+		engine->removeTrace(trace_sub);
 	}
 	
 	/* mark return value before sweeping */
@@ -380,9 +397,6 @@ SIGINT_END:
 	// gc_engine->collectGarbage();
 	gc_engine->checkGC();
 
-	/* dispose context chain copied */
-	Ink_ContextChain::disposeContextChain(context);
-
 	/* link remaining objects to previous GC engine */
 	if (engine->coro_tmp_engine) engine->coro_tmp_engine->link(gc_engine);
 	else if (gc_engine_backup) {
@@ -392,7 +406,12 @@ SIGINT_END:
 	/* restore GC engine */
 	engine->setCurrentGC(gc_engine_backup);
 	engine->setGlobalReturnValue(NULL);
-	delete gc_engine;
+
+	if (is_ref) {
+		/* dispose context chain copied */
+		Ink_ContextChain::disposeContextChain(context);
+	}
+	engine->freeFrame(frame);
 
 	return ret_val ? ret_val : NULL_OBJ; // return the last expression
 }
@@ -404,6 +423,8 @@ Ink_Object *Ink_FunctionObject::clone(Ink_InterpreteEngine *engine)
 	new_obj->is_native = is_native;
 	new_obj->is_inline = is_inline;
 	new_obj->is_ref = is_ref;
+	new_obj->is_simple_frame = is_simple_frame;
+	new_obj->scope = scope;
 	new_obj->native = native;
 
 	new_obj->param = param;
@@ -436,6 +457,8 @@ Ink_Object *Ink_FunctionObject::cloneDeep(Ink_InterpreteEngine *engine)
 		new_obj->is_native = is_native;
 		new_obj->is_inline = is_inline;
 		new_obj->is_ref = is_ref;
+		new_obj->is_simple_frame = is_simple_frame;
+		new_obj->scope = scope;
 		new_obj->native = native;
 
 		new_obj->param = param;
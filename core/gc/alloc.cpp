@@ -0,0 +1,362 @@
+#include <pthread.h>
+#include "alloc.h"
+#include "../../includes/universal.h"
+
+#ifndef INK_PLATFORM_WIN32
+	#include <sys/mman.h>
+	#ifndef MAP_ANONYMOUS
+		#define MAP_ANONYMOUS MAP_ANON
+	#endif
+#endif
+
+namespace ink {
+
+struct IGC_FreeNode {
+	IGC_FreeNode *next;
+};
+
+/* header at the beginning of each slab, nodes follow it */
+struct IGC_Slab {
+	IGC_Slab *next;
+	size_t free_count; /* only counted while releasing */
+};
+
+struct IGC_Pool {
+	IGC_FreeNode *free_list;
+	IGC_Slab *slab_list; /* the first one is being carved */
+	size_t slab_count;
+	char *slab_cur; /* nodes not yet handed out in the latest slab */
+	char *slab_end;
+	size_t node_size;
+	Ink_UInt64 alloc_count;
+	Ink_UInt64 reuse_count;
+	Ink_UInt64 free_count;
+};
+
+static __thread IGC_Pool igc_pool[IGC_POOL_COUNT];
+static __thread bool igc_is_thread_registered = false;
+
+/* nodes and slabs left by threads exited */
+static IGC_FreeNode *igc_orphan_list[IGC_POOL_COUNT];
+static IGC_Slab *igc_orphan_slab_list[IGC_POOL_COUNT];
+static pthread_mutex_t igc_orphan_list_lock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_key_t igc_thread_exit_key;
+static pthread_once_t igc_thread_exit_key_once = PTHREAD_ONCE_INIT;
+
+inline size_t roundSize(size_t size)
+{
+	return (size + IGC_SIZE_CLASS_UNIT - 1) / IGC_SIZE_CLASS_UNIT * IGC_SIZE_CLASS_UNIT;
+}
+
+/* keep nodes aligned to the size class unit */
+#define IGC_SLAB_HEADER_SIZE (roundSize(sizeof(IGC_Slab)))
+
+/* slabs are mapped on their own so releasing one returns its pages */
+static IGC_Slab *IGC_mapSlab()
+{
+#ifdef INK_PLATFORM_WIN32
+	return (IGC_Slab *)malloc(IGC_SLAB_SIZE);
+#else
+	void *ret = mmap(NULL, IGC_SLAB_SIZE, PROT_READ | PROT_WRITE,
+					 MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+	return ret == MAP_FAILED ? NULL : (IGC_Slab *)ret;
+#endif
+}
+
+static void IGC_unmapSlab(IGC_Slab *slab)
+{
+#ifdef INK_PLATFORM_WIN32
+	free(slab);
+#else
+	munmap(slab, IGC_SLAB_SIZE);
+#endif
+	return;
+}
+
+/* append the slabs of list after the one being carved */
+static void IGC_adoptSlab(IGC_Pool *pool, IGC_Slab *list)
+{
+	IGC_Slab *last;
+
+	if (!list) return;
+
+	for (last = list; ; last = last->next) {
+		pool->slab_count++;
+		if (!last->next) break;
+	}
+
+	if (pool->slab_list) {
+		last->next = pool->slab_list->next;
+		pool->slab_list->next = list;
+	} else {
+		pool->slab_list = list;
+	}
+
+	return;
+}
+
+static void IGC_orphanPool(void *arg)
+{
+	IGC_Pool *pool;
+	IGC_FreeNode *node;
+	IGC_Slab *slab;
+	size_t i;
+
+	pthread_mutex_lock(&igc_orphan_list_lock);
+	for (i = 0; i < IGC_POOL_COUNT; i++) {
+		pool = &igc_pool[i];
+		for (; pool->slab_cur && pool->slab_cur + pool->node_size <= pool->slab_end;
+			 pool->slab_cur += pool->node_size) {
+			node = (IGC_FreeNode *)pool->slab_cur;
+			node->next = igc_orphan_list[i];
+			igc_orphan_list[i] = node;
+		}
+		while ((node = pool->free_list) != NULL) {
+			pool->free_list = node->next;
+			node->next = igc_orphan_list[i];
+			igc_orphan_list[i] = node;
+		}
+		if (pool->slab_list) {
+			for (slab = pool->slab_list; slab->next; slab = slab->next) ;
+			slab->next = igc_orphan_slab_list[i];
+			igc_orphan_slab_list[i] = pool->slab_list;
+			pool->slab_list = NULL;
+			pool->slab_count = 0;
+		}
+	}
+	pthread_mutex_unlock(&igc_orphan_list_lock);
+
+	return;
+}
+
+static void IGC_initThreadExitKey()
+{
+	pthread_key_create(&igc_thread_exit_key, IGC_orphanPool);
+	return;
+}
+
+static void *IGC_refillPool(IGC_Pool *pool, IGC_PoolTag tag)
+{
+	IGC_FreeNode *ret;
+	IGC_Slab *slab;
+
+	if (!igc_is_thread_registered) {
+		/* the value only has to be non-NULL for the destructor to be called */
+		pthread_once(&igc_thread_exit_key_once, IGC_initThreadExitKey);
+		pthread_setspecific(igc_thread_exit_key, &igc_is_thread_registered);
+		igc_is_thread_registered = true;
+	}
+
+	pthread_mutex_lock(&igc_orphan_list_lock);
+	ret = igc_orphan_list[tag];
+	igc_orphan_list[tag] = NULL;
+	/* nodes of the slabs are taken at the same time, so the slabs can be released here */
+	slab = igc_orphan_slab_list[tag];
+	igc_orphan_slab_list[tag] = NULL;
+	pthread_mutex_unlock(&igc_orphan_list_lock);
+
+	IGC_adoptSlab(pool, slab);
+
+	if (ret) {
+		pool->free_list = ret->next;
+		pool->reuse_count++;
+		return ret;
+	}
+
+	if (!(slab = IGC_mapSlab())) {
+		pool->slab_cur = pool->slab_end = NULL;
+		return NULL;
+	}
+	slab->next = pool->slab_list;
+	slab->free_count = 0;
+	pool->slab_list = slab;
+	pool->slab_count++;
+
+	pool->slab_cur = (char *)slab + IGC_SLAB_HEADER_SIZE;
+	pool->slab_end = (char *)slab + IGC_SLAB_SIZE;
+
+	ret = (IGC_FreeNode *)pool->slab_cur;
+	pool->slab_cur += pool->node_size;
+
+	return ret;
+}
+
+inline void *IGC_allocateNode(IGC_PoolTag tag, size_t node_size)
+{
+	IGC_Pool *pool = &igc_pool[tag];
+	IGC_FreeNode *ret;
+
+	pool->alloc_count++;
+	if ((ret = pool->free_list) != NULL) {
+		pool->free_list = ret->next;
+		pool->reuse_count++;
+		return ret;
+	}
+
+	pool->node_size = node_size;
+	if ((size_t)(pool->slab_end - pool->slab_cur) < node_size)
+		return IGC_refillPool(pool, tag);
+
+	ret = (IGC_FreeNode *)pool->slab_cur;
+	pool->slab_cur += node_size;
+
+	return ret;
+}
+
+inline void IGC_freeNode(IGC_PoolTag tag, void *ptr)
+{
+	IGC_Pool *pool = &igc_pool[tag];
+	IGC_FreeNode *node = (IGC_FreeNode *)ptr;
+
+	pool->free_count++;
+	node->next = pool->free_list;
+	pool->free_list = node;
+
+	return;
+}
+
+void *IGC_allocate(size_t size)
+{
+	if (size > IGC_SIZE_CLASS_MAX || !size)
+		return malloc(size);
+
+	size = roundSize(size);
+	return IGC_allocateNode((IGC_PoolTag)(size / IGC_SIZE_CLASS_UNIT - 1), size);
+}
+
+void IGC_free(void *ptr, size_t size)
+{
+	if (!ptr)
+		return;
+
+	if (size > IGC_SIZE_CLASS_MAX || !size) {
+		free(ptr);
+		return;
+	}
+
+	IGC_freeNode((IGC_PoolTag)(roundSize(size) / IGC_SIZE_CLASS_UNIT - 1), ptr);
+
+	return;
+}
+
+void *IGC_allocateFrom(IGC_PoolTag pool, size_t size)
+{
+	return IGC_allocateNode(pool, roundSize(size));
+}
+
+void IGC_freeTo(IGC_PoolTag pool, void *ptr)
+{
+	if (ptr)
+		IGC_freeNode(pool, ptr);
+	return;
+}
+
+static int IGC_compareSlab(const void *a, const void *b)
+{
+	uintptr_t x = (uintptr_t)*(IGC_Slab **)a, y = (uintptr_t)*(IGC_Slab **)b;
+	return x < y ? -1 : x > y;
+}
+
+/* slabs: sorted
+ * return: slab containing ptr, NULL if it's carved from a slab of another thread */
+static IGC_Slab *IGC_findSlab(IGC_Slab **slabs, size_t count, void *ptr)
+{
+	size_t lo = 0, hi = count, mid;
+
+	while (lo < hi) {
+		mid = (lo + hi) / 2;
+		if ((uintptr_t)slabs[mid] <= (uintptr_t)ptr) lo = mid + 1;
+		else hi = mid;
+	}
+
+	if (lo && (uintptr_t)ptr < (uintptr_t)slabs[lo - 1] + IGC_SLAB_SIZE)
+		return slabs[lo - 1];
+
+	return NULL;
+}
+
+static void IGC_releasePool(IGC_Pool *pool)
+{
+	IGC_Slab **slabs, *slab, **link;
+	IGC_FreeNode *node, **node_link;
+	size_t count, capacity, kept, released;
+
+	/* the slab being carved is kept */
+	if (pool->slab_count < 2 || !pool->free_list)
+		return;
+
+	count = 0;
+	if (!(slabs = (IGC_Slab **)malloc((pool->slab_count - 1) * sizeof(IGC_Slab *))))
+		return;
+	for (slab = pool->slab_list->next; slab; slab = slab->next) {
+		slabs[count++] = slab;
+	}
+	qsort(slabs, count, sizeof(IGC_Slab *), IGC_compareSlab);
+
+	/* slabs other than the first are carved up, so a slab is free when all its nodes are in the list */
+	capacity = (IGC_SLAB_SIZE - IGC_SLAB_HEADER_SIZE) / pool->node_size;
+	for (node = pool->free_list; node; node = node->next) {
+		if ((slab = IGC_findSlab(slabs, count, node)) != NULL)
+			slab->free_count++;
+	}
+
+	/* a few free slabs are kept for the nursery refilling right after */
+	for (slab = pool->slab_list->next, kept = released = 0; slab; slab = slab->next) {
+		if (slab->free_count != capacity) continue;
+		if (kept < IGC_SLAB_FREE_KEPT) {
+			slab->free_count = 0;
+			kept++;
+		} else {
+			released++;
+		}
+	}
+
+	for (node_link = &pool->free_list; released && (node = *node_link) != NULL;) {
+		if ((slab = IGC_findSlab(slabs, count, node)) != NULL
+			&& slab->free_count == capacity) {
+			*node_link = node->next;
+		} else {
+			node_link = &node->next;
+		}
+	}
+
+	for (link = &pool->slab_list->next; (slab = *link) != NULL;) {
+		if (slab->free_count == capacity) {
+			*link = slab->next;
+			IGC_unmapSlab(slab);
+			pool->slab_count--;
+		} else {
+			slab->free_count = 0;
+			link = &slab->next;
+		}
+	}
+
+	free(slabs);
+
+	return;
+}
+
+void IGC_releaseFreeSlab()
+{
+	size_t i;
+
+	for (i = 0; i < IGC_POOL_COUNT; i++) {
+		IGC_releasePool(&igc_pool[i]);
+	}
+
+	return;
+}
+
+IGC_AllocStat IGC_getAllocStat(IGC_PoolTag tag)
+{
+	IGC_Pool *pool = &igc_pool[tag];
+	IGC_AllocStat ret;
+
+	ret.alloc_count = pool->alloc_count;
+	ret.reuse_count = pool->reuse_count;
+	ret.free_count = pool->free_count;
+
+	return ret;
+}
+
+}
@@ -0,0 +1,50 @@
+#ifndef _GC_ALLOC_H_
+#define _GC_ALLOC_H_
+
+#include <stdlib.h>
+#include "../inttype.h"
+
+#define IGC_SIZE_CLASS_UNIT (16)
+#define IGC_SIZE_CLASS_COUNT (32) /* larger objects are left to malloc */
+#define IGC_SIZE_CLASS_MAX (IGC_SIZE_CLASS_UNIT * IGC_SIZE_CLASS_COUNT)
+#define IGC_SLAB_SIZE (64 * 1024)
+#define IGC_SLAB_FREE_KEPT (16) /* free slabs of each pool kept after a major collection */
+
+namespace ink {
+
+/* pools 0 to IGC_SIZE_CLASS_COUNT - 1 are the size classes,
+ * the rest are kept for nodes of a fixed size so their counters stay apart */
+typedef enum {
+	IGC_POOL_SLOT = IGC_SIZE_CLASS_COUNT, /* Ink_HashTable */
+	IGC_POOL_COUNT
+} IGC_PoolTag;
+
+class IGC_AllocStat {
+public:
+	Ink_UInt64 alloc_count;
+	Ink_UInt64 reuse_count; /* allocations served by a node freed before */
+	Ink_UInt64 free_count;
+
+	IGC_AllocStat()
+	: alloc_count(0), reuse_count(0), free_count(0)
+	{ }
+};
+
+/* nodes are carved from slabs and recycled through free lists of each thread
+ * lists and slabs of a thread exiting are left to other threads */
+void *IGC_allocate(size_t size);
+void IGC_free(void *ptr, size_t size);
+
+void *IGC_allocateFrom(IGC_PoolTag pool, size_t size);
+void IGC_freeTo(IGC_PoolTag pool, void *ptr);
+
+/* return slabs of the current thread whose nodes are all in its free lists,
+ * called when a major collection ends */
+void IGC_releaseFreeSlab();
+
+/* return: counters of the current thread */
+IGC_AllocStat IGC_getAllocStat(IGC_PoolTag pool);
+
+}
+
+#endif
@@ -7,11 +7,9 @@ namespace ink {
 
 void IGC_addObject(Ink_InterpreteEngine *current_engine, Ink_Object *obj)
 {
-	IGC_CollectUnit *new_unit;
-
 	if (current_engine) {
-		new_unit = new IGC_CollectUnit(obj);
-		current_engine->getCurrentGC()->addUnit(new_unit);
+		current_engine->getCurrentGC()->addUnit(&obj->gc_unit);
+		current_engine->igc_alloc_count++;
 	}
 
 	return;
@@ -20,7 +18,7 @@ void IGC_addObject(Ink_InterpreteEngine *current_engine, Ink_Object *obj)
 void IGC_addObject(IGC_CollectEngine *engine, Ink_Object *obj)
 {
 	if (engine) {
-		engine->addUnit(new IGC_CollectUnit(obj));
+		engine->addUnit(&obj->gc_unit);
 	}
 
 	return;
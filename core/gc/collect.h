@@ -9,42 +9,32 @@
 
 namespace ink {
 
-class IGC_CollectUnit {
-public:
-	IGC_CollectUnit *prev;
-	Ink_Object *obj;
-	IGC_CollectUnit *next;
-
-	IGC_CollectUnit(Ink_Object *obj)
-	: obj(obj)
-	{
-		prev = NULL;
-		next = NULL;
-	}
-
-	~IGC_CollectUnit()
-	{
-		if (prev)
-			prev->next = next;
-		if (next)
-			next->prev = prev;
-		if (obj)
-			delete obj;
-	}
-};
-
 class IGC_CollectEngine {
 public:
 	Ink_TypeTag type;
 
+	/* nursery -- objects not yet survived a collection */
 	IGC_CollectUnit *object_chain;
 	IGC_CollectUnit *object_chain_last;
+
+	/* objects survived a collection in mark period old_period
+	 * they stay black(or grey) until the period is updated, so they are only swept then */
+	IGC_CollectUnit *old_chain;
+	IGC_CollectUnit *old_chain_last;
+	IGC_MarkType old_period;
+
+	/* objects left to be swept by an incremental collection */
+	IGC_CollectUnit *sweep_chain;
+	/* the old generation is swept with it, free slabs are released when it's done */
+	bool is_major_sweep;
+
 	Ink_InterpreteEngine *engine;
 
 	IGC_ObjectCountType object_count;
 	IGC_ObjectCountType collect_threshold;
 
 	IGC_CollectEngine(Ink_InterpreteEngine *engine);
+	void reset();
 
 	void addUnit(IGC_CollectUnit *unit);
 	// void addPardon(Ink_Object *obj);
@@ -53,14 +43,34 @@ public:
 		doMark(engine, obj);
 		return;
 	}
+	/* mark obj and all objects reachable from it */
 	static void doMark(Ink_InterpreteEngine *engine, Ink_Object *obj);
+	/* mark obj and leave its children to the mark stack */
+	static void pushMark(Ink_InterpreteEngine *engine, Ink_Object *obj);
+	/* mark children of at most max_mark(0 for no limit) objects in the mark stack
+	 * return: if the stack is emptied */
+	static bool drainMark(Ink_InterpreteEngine *engine, IGC_ObjectCountType max_mark = 0);
+	/* push objects of the grey list, the latest greyed first */
+	void pushGreyList(IGC_GreyList::size_type max_mark);
+	void markRoots();
+	/* one slice of an incremental collection
+	 * return: if the marking is done */
+	bool markSlice();
 	void deleteObject(IGC_CollectUnit *unit);
 	void disposeChainWithoutDelete(IGC_CollectUnit *chain);
+	void promote(IGC_CollectUnit *unit);
+	void sweepUnit(IGC_CollectUnit *unit, bool delete_all);
 
 	void doCollect(bool delete_all = false);
 	void collectGarbage(bool delete_all = false);
 	void preMark(IGC_GreyList::size_type max_mark = IGC_PREMARK_MAX);
+	/* detach the chains to sweep, objects allocated later go to a new nursery */
+	void startSweep();
+	/* sweep at most max_sweep(0 for no limit) objects detached
+	 * return: if the sweeping is done */
+	bool sweepSlice(IGC_ObjectCountType max_sweep = 0);
 	void checkGC();
+	void updateThreshold();
 	void link(IGC_CollectEngine *engine);
 
 	~IGC_CollectEngine()
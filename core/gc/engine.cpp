@@ -14,32 +14,60 @@ namespace ink {
 
 IGC_CollectEngine::IGC_CollectEngine(Ink_InterpreteEngine *engine)
 : engine(engine)
+{
+	reset();
+}
+
+void IGC_CollectEngine::reset()
 {
 	type = INK_NULL;
 	object_chain = NULL;
 	object_chain_last = NULL;
+	old_chain = NULL;
+	old_chain_last = NULL;
+	old_period = MARK_WHITE;
+	sweep_chain = NULL;
+	is_major_sweep = false;
 	object_count = 0;
 	collect_threshold = engine->igc_collect_threshold;
+
+	return;
 }
 
-void IGC_CollectEngine::addUnit(IGC_CollectUnit *unit)
+inline void appendChain(IGC_CollectUnit *&head, IGC_CollectUnit *&last,
+						IGC_CollectUnit *from_head, IGC_CollectUnit *from_last)
 {
-	if (object_chain_last) {
-		object_chain_last->next = unit;
-		unit->prev = object_chain_last;
+	if (!from_head)
+		return;
+
+	if (last) {
+		last->next = from_head;
+		from_head->prev = last;
 	} else {
-		object_chain = unit;
+		head = from_head;
 	}
-	object_chain_last = unit;
+	last = from_last;
+
+	return;
+}
+
+void IGC_CollectEngine::addUnit(IGC_CollectUnit *unit)
+{
+	appendChain(object_chain, object_chain_last, unit, unit);
 	CURRENT_OBJECT_COUNT++;
 
 	return;
 }
 
-void IGC_CollectEngine::doMark(Ink_InterpreteEngine *engine, Ink_Object *obj)
+void IGC_CollectEngine::promote(IGC_CollectUnit *unit)
 {
-	Ink_HashTable *i;
+	unit->prev = unit->next = NULL;
+	appendChain(old_chain, old_chain_last, unit, unit);
+	return;
+}
 
+void IGC_CollectEngine::pushMark(Ink_InterpreteEngine *engine, Ink_Object *obj)
+{
 	if (!obj)
 		return;
 
@@ -49,38 +77,130 @@ void IGC_CollectEngine::doMark(Ink_InterpreteEngine *engine, Ink_Object *obj)
 	// obj->incAge();
 
 	SET_BLACK(obj);
+	engine->igc_mark_stack.push_back(obj);
+
+	return;
+}
+
+inline void markChildren(Ink_InterpreteEngine *engine, Ink_Object *obj)
+{
+	Ink_HashTable *i;
 
-	doMark(engine, obj->getBase());
+	IGC_CollectEngine::pushMark(engine, obj->getBase());
 
 	if (obj->proto_hash && !obj->proto_hash->isConstant()) {
-		doMark(engine, obj->proto_hash->getValue());
+		IGC_CollectEngine::pushMark(engine, obj->proto_hash->getValue());
 		if (obj->proto_hash->getSetter()) {
-			doMark(engine, obj->proto_hash->getSetter());
+			IGC_CollectEngine::pushMark(engine, obj->proto_hash->getSetter());
 		}
 		if (obj->proto_hash->getGetter()) {
-			doMark(engine, obj->proto_hash->getGetter());
+			IGC_CollectEngine::pushMark(engine, obj->proto_hash->getGetter());
 		}
 	}
 
 	for (i = obj->hash_table; i; i = i->next) {
 		if (!i->isConstant()) {
-			doMark(engine, i->getValue());
+			IGC_CollectEngine::pushMark(engine, i->getValue());
 			if (i->getSetter())
-				doMark(engine, i->getSetter());
+				IGC_CollectEngine::pushMark(engine, i->getSetter());
 			if (i->getGetter())
-				doMark(engine, i->getGetter());
+				IGC_CollectEngine::pushMark(engine, i->getGetter());
 		}
 	}
 
-	obj->doSelfMark(engine, doMark);
+	obj->doSelfMark(engine, IGC_CollectEngine::pushMark);
+
+	return;
+}
+
+bool IGC_CollectEngine::drainMark(Ink_InterpreteEngine *engine, IGC_ObjectCountType max_mark)
+{
+	IGC_MarkStack &stack = engine->igc_mark_stack;
+	IGC_ObjectCountType count = 0;
+	Ink_Object *obj;
+
+	/* children are pushed instead of marked recursively,
+	 * so long chains of objects don't overflow the native stack */
+	while (!stack.empty()) {
+		if (max_mark && count++ >= max_mark)
+			return false;
+		obj = stack.back();
+		stack.pop_back();
+		markChildren(engine, obj);
+	}
+
+	return true;
+}
+
+void IGC_CollectEngine::doMark(Ink_InterpreteEngine *engine, Ink_Object *obj)
+{
+	pushMark(engine, obj);
+	drainMark(engine);
+	return;
+}
+
+void IGC_CollectEngine::pushGreyList(IGC_GreyList::size_type max_mark)
+{
+	IGC_GreyList &grey_list = engine->getGreyList();
+	Ink_Object *obj;
+
+	while (!grey_list.empty() && max_mark--) {
+		obj = grey_list.back();
+		grey_list.pop_back();
+		/* blackened since it was greyed */
+		if (IS_GREY(obj))
+			pushMark(engine, obj);
+	}
+
+	return;
+}
+
+void IGC_CollectEngine::markRoots()
+{
+	Ink_PardonList::iterator pardon_iter;
+	vector<DBG_TypeMapping *>::iterator type_iter;
+
+	engine->trace->doSelfMark(engine, pushMark);
+	for (pardon_iter = engine->igc_pardon_list.begin();
+		 pardon_iter != engine->igc_pardon_list.end(); pardon_iter++) {
+		pushMark(engine, *pardon_iter);
+	}
+
+	for (type_iter = engine->dbg_type_mapping.begin();
+		 type_iter != engine->dbg_type_mapping.end(); type_iter++) {
+		pushMark(engine, (*type_iter)->proto);
+	}
+
+	pushGreyList(engine->getGreyList().size());
+
+	pushMark(engine, engine->getInterruptValue());
+	pushMark(engine, engine->getGlobalReturnValue());
 
 	return;
 }
 
+bool IGC_CollectEngine::markSlice()
+{
+	if (!drainMark(engine, engine->igc_mark_budget))
+		return false;
+
+	/* remark -- the roots may have changed and black objects may have been greyed
+	 * by the write barrier since the marking started, the rest is marked at once */
+	markRoots();
+	drainMark(engine);
+	engine->igc_is_marking = false;
+
+	/* the sweep may be many slices away, bondings to unreachable slots
+	 * are broken now, as the stop-the-world collector would do here */
+	engine->breakDisposableBonding();
+
+	return true;
+}
+
 void IGC_CollectEngine::deleteObject(IGC_CollectUnit *unit)
 {
 	CURRENT_OBJECT_COUNT--;
-	delete unit;
+	delete unit->obj;
 	return;
 }
 
@@ -90,10 +210,20 @@ void IGC_CollectEngine::disposeChainWithoutDelete(IGC_CollectUnit *chain)
 	for (i = chain; i;) {
 		tmp = i;
 		i = i->next;
-		tmp->obj = NULL;
 		tmp->prev = NULL;
 		tmp->next = NULL;
-		delete tmp;
+	}
+
+	return;
+}
+
+void IGC_CollectEngine::sweepUnit(IGC_CollectUnit *unit, bool delete_all)
+{
+	if (delete_all || IS_DISPOSABLE(unit->obj)) {
+		unit->prev = unit->next = NULL;
+		deleteObject(unit);
+	} else {
+		promote(unit);
 	}
 
 	return;
@@ -101,41 +231,106 @@ void IGC_CollectEngine::disposeChainWithoutDelete(IGC_CollectUnit *chain)
 
 void IGC_CollectEngine::doCollect(bool delete_all)
 {
-	IGC_CollectUnit *i, *tmp,
-					*last = NULL,
-					*head = NULL;
+	IGC_CollectUnit *i, *tmp;
+	bool is_major = false;
+
+	if (sweep_chain) {
+		/* the last incremental collection is swept up first */
+		for (i = sweep_chain; i;) {
+			tmp = i;
+			i = i->next;
+			sweepUnit(tmp, delete_all);
+		}
+		sweep_chain = NULL;
+		engine->igc_sweeping = NULL;
+	}
 
-	for (i = head = object_chain; i;) {
+	if (delete_all || old_period != engine->curBlack()) {
+		/* major collection -- marks of the old generation are out of date */
+		appendChain(old_chain, old_chain_last, object_chain, object_chain_last);
+		object_chain = old_chain;
+		object_chain_last = old_chain_last;
+		old_chain = old_chain_last = NULL;
+		old_period = engine->curBlack();
+		is_major = true;
+	}
+
+	/* minor collection -- only the nursery is swept, survivors are promoted */
+	for (i = object_chain; i;) {
 		tmp = i;
 		i = i->next;
-		if (delete_all || IS_DISPOSABLE(tmp->obj)) {
-			// if (tmp == object_chain) object_chain = i;
-			if (tmp == head) {
-				head = tmp->next;
-			}
-			deleteObject(tmp);
-		} else {
-			last = tmp;
-		}
+		sweepUnit(tmp, delete_all);
+	}
+	object_chain = object_chain_last = NULL;
+
+	if (is_major || is_major_sweep) {
+		is_major_sweep = false;
+		IGC_releaseFreeSlab();
 	}
-	// for (i = last; i && i->prev; i = i->prev) ;
-	object_chain = head;
-	object_chain_last = last;
 
 	return;
 }
 
+void IGC_CollectEngine::startSweep()
+{
+	if (old_period != engine->curBlack()) {
+		appendChain(old_chain, old_chain_last, object_chain, object_chain_last);
+		object_chain = old_chain;
+		old_chain = old_chain_last = NULL;
+		old_period = engine->curBlack();
+		is_major_sweep = true;
+	}
+
+	sweep_chain = object_chain;
+	object_chain = object_chain_last = NULL;
+	engine->igc_sweeping = this;
+
+	return;
+}
+
+bool IGC_CollectEngine::sweepSlice(IGC_ObjectCountType max_sweep)
+{
+	IGC_ObjectCountType count = 0;
+	IGC_CollectUnit *tmp;
+
+	while (sweep_chain) {
+		if (max_sweep && count++ >= max_sweep)
+			return false;
+		tmp = sweep_chain;
+		sweep_chain = sweep_chain->next;
+		sweepUnit(tmp, false);
+	}
+
+	/* the threshold may update the mark period,
+	 * so it waits until all objects marked in this period are swept */
+	engine->igc_sweeping = NULL;
+	updateThreshold();
+
+	if (is_major_sweep) {
+		is_major_sweep = false;
+		IGC_releaseFreeSlab();
+	}
+
+	return true;
+}
+
 void IGC_CollectEngine::link(IGC_CollectEngine *engine)
 {
-	if (object_chain_last) {
-		object_chain_last->next = engine->object_chain;
-		if (engine->object_chain)
-			engine->object_chain->prev = object_chain_last;
+	if (this->engine->igc_sweeping == engine) {
+		engine->sweepSlice();
+	}
+
+	if (!old_chain) {
+		old_period = engine->old_period;
+	}
+
+	if (engine->old_period == old_period) {
+		appendChain(old_chain, old_chain_last, engine->old_chain, engine->old_chain_last);
 	} else {
-		object_chain = engine->object_chain;
+		/* promoted in another mark period, sweep them with the nursery */
+		appendChain(object_chain, object_chain_last, engine->old_chain, engine->old_chain_last);
 	}
-	if (engine->object_chain_last)
-		object_chain_last = engine->object_chain_last;
+	appendChain(object_chain, object_chain_last, engine->object_chain, engine->object_chain_last);
 
 	object_count += engine->object_count;
 
@@ -144,31 +339,11 @@ void IGC_CollectEngine::link(IGC_CollectEngine *engine)
 
 void IGC_CollectEngine::collectGarbage(bool delete_all)
 {
-	Ink_PardonList::iterator pardon_iter;
-	IGC_GreyList::iterator grey_iter;
-	IGC_GreyList grey_list;
-	vector<DBG_TypeMapping *>::iterator type_iter;
-
 	if (!delete_all) {
-		engine->trace->doSelfMark(engine, doMark);
-		for (pardon_iter = engine->igc_pardon_list.begin();
-			 pardon_iter != engine->igc_pardon_list.end(); pardon_iter++) {
-			doMark(*pardon_iter);
-		}
-
-		for (type_iter = engine->dbg_type_mapping.begin();
-			 type_iter != engine->dbg_type_mapping.end(); type_iter++) {
-			doMark((*type_iter)->proto);
-		}
-
-		grey_list = engine->getGreyList();
-		for (grey_iter = grey_list.begin();
-			 grey_iter != grey_list.end(); grey_iter++) {
-			doMark(*grey_iter);
-		}
-
-		doMark(engine->getInterruptValue());
-		doMark(engine->getGlobalReturnValue());
+		/* marks left by an unfinished incremental collection are still valid */
+		markRoots();
+		drainMark(engine);
+		engine->igc_is_marking = false;
 	}
 	doCollect(delete_all);
 
@@ -183,17 +358,9 @@ void IGC_CollectEngine::collectGarbage(bool delete_all)
 
 void IGC_CollectEngine::preMark(IGC_GreyList::size_type max_mark)
 {
-	IGC_GreyList::iterator grey_iter;
-	IGC_GreyList grey_list;
-	IGC_GreyList::size_type i;
-
-	grey_list = engine->getGreyList();
-	// printf("grey count: %ld\n", grey_list.size());
-	for (i = 0, grey_iter = grey_list.begin();
-		 grey_iter != grey_list.end() && i <= max_mark; grey_iter++) {
-		doMark(*grey_iter);
-	}
-
+	// printf("grey count: %ld\n", engine->getGreyList().size());
+	pushGreyList(max_mark);
+	drainMark(engine);
 	return;
 }
 
@@ -205,14 +372,53 @@ void IGC_CollectEngine::preMark(IGC_GreyList::size_type max_mark)
 
 void IGC_CollectEngine::checkGC()
 {
+	IGC_CollectEngine *sweeping;
+
+	if (engine->igc_is_marking) {
+		/* sweep the engine current when the marking is done */
+		if (markSlice())
+			startSweep();
+		return;
+	}
+
+	if ((sweeping = engine->igc_sweeping) != NULL) {
+		if (sweeping == this) {
+			sweepSlice(engine->igc_mark_budget);
+		} else if (oc >= t) {
+			/* no collection starts before the last one is swept up */
+			sweeping->sweepSlice();
+		}
+		return;
+	}
+
 #ifndef INK_DEBUG_FLAG
 	if (oc >= t) {
 #endif
 
 	// printf("before: oc: %ld; ", oc);
 
-	collectGarbage();
+	if (engine->igc_mark_budget) {
+		/* incremental -- roots are pushed now, objects reachable are marked in slices */
+		markRoots();
+		engine->igc_is_marking = true;
+		if (markSlice())
+			startSweep();
+	} else {
+		collectGarbage();
+		updateThreshold();
+	}
 
+#ifndef INK_DEBUG_FLAG
+	} else {
+		// preMark();
+	}
+#endif
+
+	return;
+}
+
+void IGC_CollectEngine::updateThreshold()
+{
 	// printf("after collect: oc: %ld, t: %ld; ", oc, t);
 	if (oc >= t) { /* increase */
 		// tu *= pow(oc / t, 2);
@@ -223,16 +429,12 @@ void IGC_CollectEngine::checkGC()
 	} else {
 		// tu *= pow(oc / t, 2);
 		t -= lower((t - oc) / (double)tu) * tu;
+		/* a zero threshold would make every later collection a major one */
+		if (t < tu) t = tu;
 		// t -= tu;
 		// printf("t recuce to: %ld\n", t);
 	}
 
-#ifndef INK_DEBUG_FLAG
-	} else {
-		// preMark();
-	}
-#endif
-
 	return;
 }
 
@@ -30,6 +30,7 @@ namespace ink {
 inline int removeDir(const std::string path, bool if_delete_sub = true);
 inline char *getCurrentDir();
 inline int changeDir(const char *path);
+inline char *getRealPath(const char *path);
 
 }
 
@@ -53,6 +54,11 @@ inline int changeDir(const char *path)
 	return chdir(path);
 }
 
+inline char *getRealPath(const char *path)
+{
+	return realpath(path, NULL);
+}
+
 }
 #elif defined(INK_PLATFORM_WIN32)
 #include <stdio.h>
@@ -124,6 +130,11 @@ inline int changeDir(const char *path)
 	return _chdir(path);
 }
 
+inline char *getRealPath(const char *path)
+{
+	return _fullpath(NULL, path, 0);
+}
+
 }
 #endif
 
@@ -186,13 +197,15 @@ typedef Ink_SInt32 IGC_MarkType;
 #define IGC_OLD_OBJECT_AGE (20)
 #define IS_OVERAGE(obj) ((obj) && (obj)->age >= IGC_OLD_OBJECT_AGE)
 
-typedef set<Ink_Object *> IGC_GreyList;
+/* objects greyed by the write barrier, entries blackened since are skipped */
+typedef std::vector<Ink_Object *> IGC_GreyList;
+/* black objects whose children are not yet marked */
+typedef std::vector<Ink_Object *> IGC_MarkStack;
 typedef Ink_UInt64 IGC_ObjectCountType;
 typedef Ink_UInt64 IGC_ObjectAge;
 
 typedef Ink_SInt64 Ink_LineNoType;
 // typedef double Ink_NumericValue;
-typedef std::vector<Ink_HashTable *> Ink_ArrayValue;
 
 inline Ink_SInt64 getInt(Ink_NumericValue val)
 {
@@ -284,6 +297,7 @@ enum Ink_ExceptionCode_tag {
 	INK_EXCODE_WARN_FIX_REQUIRE_ASSIGNABLE_ARGUMENT,
 	INK_EXCODE_WRAN_SLICE_REQUIRE_NUMERIC,
 	INK_EXCODE_WRAN_SLICE_REQUIRE_NON_ZERO_RANGE,
+	INK_EXCODE_WARN_ARRAY_CHANGED_WHILE_SORTING,
 	INK_EXCODE_LAST
 };
 
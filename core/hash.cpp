@@ -1,4 +1,7 @@
+#include <string.h>
+#include <stdlib.h>
 #include "hash.h"
+#include "symbol.h"
 #include "object.h"
 #include "constant.h"
 #include "interface/engine.h"
@@ -16,6 +19,7 @@ Ink_HashTable::Ink_HashTable(const char *k, Ink_Object *val, Ink_Object *p, stri
 	u.value = val;
 	key = k;
 	key_p = k_p;
+	is_key_interned = false;
 
 	next = NULL;
 	bonding = NULL;
@@ -46,6 +50,7 @@ Ink_HashTable::Ink_HashTable(const char *k, Ink_InterpreteEngine *engine, Ink_Co
 
 	key = k;
 	key_p = k_p;
+	is_key_interned = false;
 
 	next = NULL;
 	bonding = NULL;
@@ -72,6 +77,7 @@ Ink_HashTable::Ink_HashTable(Ink_Object *val, Ink_Object *p)
 	u.value = val;
 	key = "";
 	key_p = NULL;
+	is_key_interned = false;
 
 	next = NULL;
 	bonding = NULL;
@@ -119,6 +125,11 @@ Ink_Object *Ink_HashTable::setValue(Ink_Object *val)
 	Ink_InterpreteEngine *engine;
 	Ink_Object *p;
 
+	if (parent && parent->is_cache_watched
+		&& (hasValue() != (val != NULL) || parent->proto_hash == this)) {
+		Ink_updateSlotEpoch(parent);
+	}
+
 	if (type != HASH_CONST) {
 		u.value = val;
 		if (val) {
@@ -151,6 +162,8 @@ Ink_Object *Ink_HashTable::setValue(Ink_Object *val)
 
 Ink_Object *Ink_HashTable::setValue(Ink_InterpreteEngine *engine, Ink_Constant *val)
 {
+	Ink_updateSlotEpoch(parent);
+
 	if (type != HASH_CONST) {
 		setConstant();
 	}
@@ -191,6 +204,7 @@ void Ink_HashTable::setSetter(Ink_Object *obj)
 	Ink_Object *p;
 
 	setter = obj;
+	Ink_updateSlotEpoch(parent);
 
 	if ((p = getParent()) != NULL) {
 		engine = p->engine;
@@ -211,6 +225,7 @@ void Ink_HashTable::setGetter(Ink_Object *obj)
 	Ink_Object *p;
 
 	getter = obj;
+	Ink_updateSlotEpoch(parent);
 	
 	if ((p = getParent()) != NULL) {
 		engine = p->engine;
@@ -228,6 +243,8 @@ Ink_Object *Ink_HashTable::getGetter()
 void Ink_HashTable::setBonding(Ink_InterpreteEngine *engine, Ink_HashTable *to, bool if_remove)
 {
 	bonding = to;
+	/* a bonding may redirect lookups through any object, drop all caches */
+	engine->updateSlotEpoch();
 	if (to)
 		engine->addGCBonding(this, to);
 	else if (if_remove)
@@ -242,4 +259,85 @@ Ink_HashTable::~Ink_HashTable()
 	if (isConstant()) delete u.const_value.value;
 }
 
+Ink_HashIndex::Ink_HashIndex(Ink_HashTable *begin)
+{
+	Ink_HashTable *i;
+
+	capacity = INK_HASH_INDEX_INIT_SIZE;
+	count = 0;
+	table = (Entry *)calloc(capacity, sizeof(Entry));
+	end = NULL;
+	has_dup_key = false;
+
+	for (i = begin; i; i = i->next) {
+		append(i);
+	}
+}
+
+void Ink_HashIndex::rehash(Ink_SizeType new_capacity)
+{
+	Entry *old_table = table;
+	Ink_SizeType old_capacity = capacity;
+	Ink_SizeType i, j;
+
+	table = (Entry *)calloc(new_capacity, sizeof(Entry));
+	capacity = new_capacity;
+
+	for (i = 0; i < old_capacity; i++) {
+		if (old_table[i].slot) {
+			for (j = old_table[i].hash & (capacity - 1); table[j].slot;
+				 j = (j + 1) & (capacity - 1)) ;
+			table[j] = old_table[i];
+		}
+	}
+
+	free(old_table);
+
+	return;
+}
+
+Ink_HashTable *Ink_HashIndex::find(const char *key, const char *sym)
+{
+	Ink_UInt32 hash = hashKey(key);
+	Ink_SizeType i;
+
+	for (i = hash & (capacity - 1); table[i].slot; i = (i + 1) & (capacity - 1)) {
+		if (table[i].hash == hash && table[i].slot->isKey(key, sym))
+			return table[i].slot;
+	}
+
+	return NULL;
+}
+
+void Ink_HashIndex::append(Ink_HashTable *slot)
+{
+	Ink_UInt32 hash = hashKey(slot->key);
+	Ink_SizeType i;
+
+	end = slot;
+
+	/* keep the load factor under 1/2 */
+	if ((count + 1) * 2 > capacity)
+		rehash(capacity * 2);
+
+	for (i = hash & (capacity - 1); table[i].slot; i = (i + 1) & (capacity - 1)) {
+		if (table[i].hash == hash && table[i].slot->isKey(slot)) {
+			/* the first node of the key stays indexed */
+			has_dup_key = true;
+			return;
+		}
+	}
+
+	table[i].hash = hash;
+	table[i].slot = slot;
+	count++;
+
+	return;
+}
+
+Ink_HashIndex::~Ink_HashIndex()
+{
+	free(table);
+}
+
 }
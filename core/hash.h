@@ -1,9 +1,13 @@
 #ifndef _HASH_H_
 #define _HASH_H_
 
+#include <new>
 #include <string>
 #include <stdio.h>
+#include <string.h>
 #include "constant.h"
+#include "inttype.h"
+#include "gc/alloc.h"
 
 namespace ink {
 
@@ -40,6 +44,9 @@ public:
 
 	std::string *key_p;
 
+	/* set by setSlot when key is the interned copy */
+	bool is_key_interned;
+
 	Ink_HashTable(const char *key, Ink_Object *value, Ink_Object *p, string *k_p = NULL);
 
 	Ink_HashTable(const char *key, Ink_InterpreteEngine *engine, Ink_Constant *value, Ink_Object *p, std::string *key_p = NULL);
@@ -69,11 +76,29 @@ public:
 		return parent;
 	}
 
+	/* sym is InkSymbol_find(k), looked up once per access
+	 * interned keys are equal by address only, owned runtime keys fall back to strcmp */
+	inline bool isKey(const char *k, const char *sym)
+	{
+		return is_key_interned ? key == sym : !strcmp(key, k);
+	}
+
+	inline bool isKey(Ink_HashTable *slot)
+	{
+		return is_key_interned && slot->is_key_interned ? key == slot->key : !strcmp(key, slot->key);
+	}
+
 	inline bool isConstant()
 	{
 		return type == HASH_CONST;
 	}
 
+	/* same as getValue() != NULL, without converting constants */
+	inline bool hasValue()
+	{
+		return type != HASH_CONST ? u.value != NULL : u.const_value.value != NULL;
+	}
+
 	inline void initValue()
 	{
 		u.const_value.value = NULL;
@@ -115,9 +140,66 @@ public:
 		return bondee;
 	}
 
+	/* slots are recycled through their own pool */
+	static inline void *operator new(size_t size)
+	{
+		void *ret = IGC_allocateFrom(IGC_POOL_SLOT, size);
+		if (!ret) throw std::bad_alloc();
+		return ret;
+	}
+
+	static inline void operator delete(void *ptr)
+	{
+		IGC_freeTo(IGC_POOL_SLOT, ptr);
+		return;
+	}
+
 	~Ink_HashTable();
 };
 
+#define INK_HASH_INDEX_THRESHOLD 8
+#define INK_HASH_INDEX_INIT_SIZE 16
+
+/* open-addressing index over a slot chain, the chain itself keeps the insertion order */
+class Ink_HashIndex {
+	struct Entry {
+		Ink_UInt32 hash;
+		Ink_HashTable *slot;
+	};
+
+	Entry *table;
+	Ink_SizeType capacity; /* always a power of 2 */
+	Ink_SizeType count;
+
+	void rehash(Ink_SizeType new_capacity);
+
+public:
+	/* last node of the chain */
+	Ink_HashTable *end;
+	/* set when two nodes share the same key, lookups must then walk the chain */
+	bool has_dup_key;
+
+	Ink_HashIndex(Ink_HashTable *begin);
+
+	static inline Ink_UInt32 hashKey(const char *key)
+	{
+		Ink_UInt32 hash = 2166136261U;
+
+		for (; *key; key++) {
+			hash ^= (Ink_UInt8)*key;
+			hash *= 16777619U;
+		}
+
+		return hash;
+	}
+
+	/* return the first node in the chain with the given key, sym is InkSymbol_find(key) */
+	Ink_HashTable *find(const char *key, const char *sym);
+	void append(Ink_HashTable *slot);
+
+	~Ink_HashIndex();
+};
+
 }
 
 #endif
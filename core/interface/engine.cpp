@@ -7,6 +7,7 @@
 #include "core/native/native.h"
 #include "core/thread/thread.h"
 #include "core/gc/collect.h"
+#include "core/ivm/ivm.h"
 
 namespace ink {
 	
@@ -49,6 +50,8 @@ void Ink_addNativeExpression(Ink_Expression *expr)
 	return;
 }
 
+static Ink_UInt64 ink_slot_epoch_seed = 0;
+
 Ink_InterpreteEngine::Ink_InterpreteEngine()
 {
 	// gc_lock.init();
@@ -60,12 +63,27 @@ Ink_InterpreteEngine::Ink_InterpreteEngine()
 	igc_global_ret_val = NULL;
 	igc_pardon_list = Ink_PardonList();
 	igc_grey_list = IGC_GreyList();
+	igc_mark_stack = IGC_MarkStack();
+	igc_mark_budget = 0;
+	igc_is_marking = false;
+	igc_sweeping = NULL;
+	igc_alloc_count = 0;
+	memset(numeric_cache, 0, sizeof(numeric_cache));
+	memset(numeric_table, 0, sizeof(numeric_table));
+	numeric_table_count = 0;
+	is_addressed_call = false;
+	/* epochs of different engines never meet, so a cache left by a dead engine stays invalid */
+	slot_epoch = __atomic_add_fetch(&ink_slot_epoch_seed, (Ink_UInt64)1 << 32, __ATOMIC_RELAXED);
+	has_context_missing = false;
 
 	error_mode = INK_ERRMODE_DEFAULT;
 
 	input_file_path = NULL;
 	current_file_name = NULL;
 	current_line_number = -1;
+
+	parse_line_number = 1;
+	parse_err_prefix = "";
 	
 	trace = NULL;
 	
@@ -75,12 +93,14 @@ Ink_InterpreteEngine::Ink_InterpreteEngine()
 	coro_tmp_engine = NULL;
 	coro_scheduler_stack = Ink_SchedulerStack();
 
+	frame_stack = Ink_CallFrameStack();
+
 	dbg_print_detail = false;
 	dbg_max_trace = DBG_DEFAULT_MAX_TRACE;
+
+	ivm_enable = false;
 	
 	protocol_map = Ink_ProtocolMap();
-	pthread_mutex_init(&message_lock, NULL);
-	message_queue = Ink_ActorMessageQueue();
 
 	pthread_mutex_init(&watcher_lock, NULL);
 	watcher_list = Ink_ActorWatcherList();
@@ -93,10 +113,10 @@ Ink_InterpreteEngine::Ink_InterpreteEngine()
 	initThread();
 	initTypeMapping();
 	initPrintDebugInfo();
-	initPrototypeSearch();
 	initGCCollect();
 
 	const_table = Ink_ConstantTable();
+	import_cache = Ink_ImportCacheMap();
 
 	gc_engine = new IGC_CollectEngine(this);
 	setCurrentGC(gc_engine);
@@ -166,13 +186,19 @@ void Ink_InterpreteEngine::removeTrace(Ink_ContextObject *context)
 	return;
 }
 
+void Ink_InterpreteEngine::removeTrace(Ink_ContextChain_sub *trace_sub)
+{
+	trace->removeSub(trace_sub);
+	return;
+}
+
 inline void setArgv(Ink_InterpreteEngine *engine, vector<char *> argv)
 {
 	unsigned int i;
 	Ink_Array *val = new Ink_Array(engine);
 
 	for (i = 0; i < argv.size(); i++) {
-		val->value.push_back(new Ink_HashTable(new Ink_String(engine, string(argv[i])), val));
+		val->pushElement(new Ink_String(engine, string(argv[i])));
 	}
 
 	engine->global_context->getGlobal()->setSlot(INK_ARGV_NAME, val);
@@ -180,11 +206,10 @@ inline void setArgv(Ink_InterpreteEngine *engine, vector<char *> argv)
 	return;
 }
 
-void Ink_InterpreteEngine::startParse(Ink_InputSetting setting)
+bool Ink_InterpreteEngine::startParse(Ink_InputSetting setting)
 {
-	InkParser_lockParseLock();
-	Ink_InterpreteEngine *backup = InkParser_getParseEngine();
-	InkParser_setParseEngine(this);
+	InkParser_State state = InkParser_State(this);
+	bool ret;
 	
 	setFilePath(setting.getFilePath());
 
@@ -192,63 +217,90 @@ void Ink_InterpreteEngine::startParse(Ink_InputSetting setting)
 	// CGC_code_mode = setting.getMode();
 	// cleanTopLevel();
 	top_level = Ink_ExpressionList();
-	yyin = setting.getInput();
-	yyparse();
-	yylex_destroy();
+	state.input_file = setting.getInput();
+	ret = !InkParser_parse(&state);
+	Ink_resolveExpressionList(top_level);
 
-	setting.clean();
+	if (ivm_enable)
+		IVM_compileExpressionList(top_level);
 
-	InkParser_setParseEngine(backup);
-	InkParser_unlockParseLock();
+	setting.clean();
 	setArgv(this, setting.getArgument());
 
-	return;
+	return ret;
 }
 
-void Ink_InterpreteEngine::startParse(FILE *input, bool close_fp)
+bool Ink_InterpreteEngine::startParse(FILE *input, bool close_fp)
 {
-	InkParser_lockParseLock();
-	Ink_InterpreteEngine *backup = InkParser_getParseEngine();
-	InkParser_setParseEngine(this);
+	InkParser_State state = InkParser_State(this);
+	bool ret;
 	
 	input_mode = INK_FILE_INPUT;
 	// cleanTopLevel();
 	top_level = Ink_ExpressionList();
-	yyin = input;
-	yyparse();
-	yylex_destroy();
+	state.input_file = input;
+	ret = !InkParser_parse(&state);
+	Ink_resolveExpressionList(top_level);
 
-	if (close_fp) fclose(input);
+	if (ivm_enable)
+		IVM_compileExpressionList(top_level);
 
-	InkParser_setParseEngine(backup);
-	InkParser_unlockParseLock();
+	if (close_fp) fclose(input);
 
-	return;
+	return ret;
 }
 
-void Ink_InterpreteEngine::startParse(string code)
+bool Ink_InterpreteEngine::startParse(string code)
 {
-	InkParser_lockParseLock();
-	Ink_InterpreteEngine *backup = InkParser_getParseEngine();
-	InkParser_setParseEngine(this);
-
-	const char **input = (const char **)malloc(2 * sizeof(char *));
+	InkParser_State state = InkParser_State(this);
+	bool ret;
+	const char *input[] = { code.c_str(), NULL };
 
-	input[0] = code.c_str();
-	input[1] = NULL;
 	input_mode = INK_STRING_INPUT;
 	// cleanTopLevel();
 	top_level = Ink_ExpressionList();
-	
-	Ink_setStringInput(input);
-	yyparse();
-	yylex_destroy();
+	state.input_string = input;
+	ret = !InkParser_parse(&state);
+	Ink_resolveExpressionList(top_level);
+
+	if (ivm_enable)
+		IVM_compileExpressionList(top_level);
+
+	return ret;
+}
+
+Ink_ExpressionList *Ink_InterpreteEngine::findImportCache(string path, Ink_SInt64 mtime, Ink_SInt64 size)
+{
+	Ink_ImportCacheMap::iterator cache_iter = import_cache.find(path);
+
+	if (cache_iter == import_cache.end())
+		return NULL;
 
-	free(input);
+	if (cache_iter->second.mtime != mtime
+		|| cache_iter->second.size != size) {
+		/* file changed, parsed expressions are kept in native list */
+		import_cache.erase(cache_iter);
+		return NULL;
+	}
+
+	return &cache_iter->second.exp_list;
+}
+
+void Ink_InterpreteEngine::setImportCache(string path, Ink_SInt64 mtime, Ink_SInt64 size, Ink_ExpressionList exp_list)
+{
+	import_cache[path] = Ink_ImportCache(mtime, size, exp_list);
+	return;
+}
 
-	InkParser_setParseEngine(backup);
-	InkParser_unlockParseLock();
+void Ink_InterpreteEngine::removeImportCache(string path)
+{
+	import_cache.erase(path);
+	return;
+}
 
+void Ink_InterpreteEngine::clearImportCache()
+{
+	import_cache.clear();
 	return;
 }
 
@@ -406,6 +458,94 @@ void Ink_InterpreteEngine::breakUnreachableBonding(Ink_HashTable *to_or_from)
 	return;
 }
 
+void Ink_InterpreteEngine::breakDisposableBonding()
+{
+	Ink_InterpreteEngine *engine = this;
+	IGC_BondingMap::iterator bond_iter;
+
+	for (bond_iter = igc_bonding_map.begin();
+		 bond_iter != igc_bonding_map.end();) {
+		/* bondings of slots garbage themselves are left to the sweep */
+		if (IS_DISPOSABLE(bond_iter->second->getParent())
+			&& !IS_DISPOSABLE(bond_iter->first->getParent())) {
+			InkWarn_Unreachable_Bonding(this);
+			bond_iter->first->setBonding(this, NULL, false);
+			getCurrentGC()->doMark(getInterruptValue());
+			igc_bonding_map.erase(bond_iter++);
+		} else {
+			bond_iter++;
+		}
+	}
+	return;
+}
+
+void Ink_InterpreteEngine::disposeFrameStack()
+{
+	Ink_CallFrameStack::size_type i;
+
+	for (i = 0; i < frame_stack.size(); i++) {
+		delete frame_stack[i];
+	}
+	frame_stack.clear();
+
+	return;
+}
+
+Ink_Numeric *Ink_InterpreteEngine::findNumeric(Ink_NumericValue value, bool if_add)
+{
+	Ink_UInt64 bits;
+	Ink_NumericValue tmp;
+	Ink_SizeType i;
+
+	/* floats are told apart by their bits, so 0.0 and -0.0 get their own entries */
+	if (value.isInt()) {
+		bits = value.ival;
+	} else {
+		memcpy(&bits, &value.fval, sizeof(bits));
+	}
+	bits ^= bits >> 29;
+	bits *= 0xbf58476d1ce4e5b9ULL;
+	bits ^= bits >> 32;
+
+	for (i = (bits + value.type) & (INK_NUMERIC_TABLE_SIZE - 1); numeric_table[i];
+		 i = (i + 1) & (INK_NUMERIC_TABLE_SIZE - 1)) {
+		tmp = numeric_table[i]->getValue();
+		if (tmp.type == value.type
+			&& (value.isInt() ? tmp.ival == value.ival
+							  : !memcmp(&tmp.fval, &value.fval, sizeof(double)))) {
+			return numeric_table[i];
+		}
+	}
+
+	if (!if_add || (numeric_table_count + 1) * 2 > INK_NUMERIC_TABLE_SIZE)
+		return NULL;
+
+	numeric_table_count++;
+	return numeric_table[i] = new Ink_Numeric(this, value, false);
+}
+
+void Ink_InterpreteEngine::disposeNumericCache()
+{
+	Ink_SizeType i;
+
+	for (i = 0; i < INK_NUMERIC_CACHE_SIZE; i++) {
+		if (numeric_cache[i]) {
+			delete numeric_cache[i];
+			numeric_cache[i] = NULL;
+		}
+	}
+
+	for (i = 0; i < INK_NUMERIC_TABLE_SIZE; i++) {
+		if (numeric_table[i]) {
+			delete numeric_table[i];
+			numeric_table[i] = NULL;
+		}
+	}
+	numeric_table_count = 0;
+
+	return;
+}
+
 void Ink_InterpreteEngine::callAllDestructor()
 {
 	Ink_CustomDestructorQueue::size_type i;
@@ -422,6 +562,7 @@ Ink_InterpreteEngine::~Ink_InterpreteEngine()
 
 	gc_engine->collectGarbage(true);
 	delete gc_engine;
+	disposeNumericCache();
 
 	disposeConstant();
 
@@ -431,6 +572,7 @@ Ink_InterpreteEngine::~Ink_InterpreteEngine()
 	
 	disposeTypeMapping();
 	disposeCustomInterruptSignal();
+	disposeFrameStack();
 }
 
 }
@@ -29,14 +29,12 @@
 #define IS_DISPOSABLE(obj) (IS_WHITE(obj))
 #define IS_IGNORED(obj) (IS_BLACK(obj))
 
-#define SET_WHITE(obj) (engine->removeIfIsGrey(obj), (obj)->mark = MARK_WHITE)
-#define SET_BLUE(obj) (engine->removeIfIsGrey(obj), (obj)->mark = MARK_BLUE)
+/* entries of the grey list are not removed, they are skipped once the mark changes */
+#define SET_WHITE(obj) ((obj)->mark = MARK_WHITE)
+#define SET_BLUE(obj) ((obj)->mark = MARK_BLUE)
 #define SET_GREY(obj) ((obj)->mark = engine->curGrey(), engine->addGrey(obj))
-#define SET_BLACK(obj) (engine->removeIfIsGrey(obj), (obj)->mark = engine->curBlack())
+#define SET_BLACK(obj) ((obj)->mark = engine->curBlack())
 
-extern FILE *yyin;
-int yyparse();
-int yylex_destroy();
 
 namespace ink {
 
@@ -68,13 +66,28 @@ typedef vector<Ink_Object *> Ink_PardonList;
 typedef vector<InkCoro_Scheduler *> Ink_SchedulerStack;
 
 typedef map<Ink_Object *, Ink_Object *> Ink_CloneTraceMap;
-typedef set<Ink_Object *> Ink_ProtoTraceSet;
 typedef set<Ink_Object *> Ink_DebugTraceSet;
 
+/* parsed source of an imported file, valid while the file keeps its mtime(in nanoseconds) & size */
+class Ink_ImportCache {
+public:
+	Ink_SInt64 mtime;
+	Ink_SInt64 size;
+	Ink_ExpressionList exp_list;
+
+	Ink_ImportCache()
+	: mtime(0), size(0), exp_list(Ink_ExpressionList())
+	{ }
+
+	Ink_ImportCache(Ink_SInt64 mtime, Ink_SInt64 size, Ink_ExpressionList exp_list)
+	: mtime(mtime), size(size), exp_list(exp_list)
+	{ }
+};
+typedef map<string, Ink_ImportCache> Ink_ImportCacheMap;
+
 extern pthread_mutex_t ink_native_exp_list_lock;
 extern Ink_ExpressionList ink_native_exp_list;
 void Ink_GlobalMethodInit(Ink_InterpreteEngine *engine, Ink_ContextChain *context);
-void Ink_setStringInput(const char **source);
 
 void Ink_initNativeExpression();
 void Ink_cleanNativeExpression();
@@ -107,6 +120,10 @@ public:
 	const char *current_file_name;
 	Ink_LineNoType current_line_number;
 
+	/* line number & error prefix the next parse starts with */
+	Ink_LineNoType parse_line_number;
+	const char *parse_err_prefix;
+
 	Ink_ContextChain *trace;
 
 	IGC_ObjectCountType igc_collect_threshold;
@@ -118,6 +135,26 @@ public:
 	Ink_Object *igc_global_ret_val;
 	Ink_PardonList igc_pardon_list;
 	IGC_GreyList igc_grey_list;
+	IGC_MarkStack igc_mark_stack;
+	/* objects marked in each slice of an incremental collection, 0 to mark all at once */
+	IGC_ObjectCountType igc_mark_budget;
+	bool igc_is_marking; /* an incremental collection is in progress */
+	IGC_CollectEngine *igc_sweeping; /* engine sweeping the last incremental collection */
+	IGC_ObjectCountType igc_alloc_count;
+
+	Ink_Numeric *numeric_cache[INK_NUMERIC_CACHE_SIZE];
+	/* open addressing, numerics out of the cache are shared here once a literal has the value */
+	Ink_Numeric *numeric_table[INK_NUMERIC_TABLE_SIZE];
+	Ink_SizeType numeric_table_count;
+	/* the call being made wants the address of its result, see Ink_CallExpression::is_addressed */
+	bool is_addressed_call;
+
+	/* changed whenever a slot of an object watched by inline caches may resolve differently */
+	Ink_UInt64 slot_epoch;
+
+	/* set once any context gets a slot named "missing",
+	 * until then identifier lookups don't search for the handler */
+	bool has_context_missing;
 
 	Ink_InterruptSignal interrupt_signal;
 	Ink_Object *interrupt_value;
@@ -125,6 +162,8 @@ public:
 	IGC_CollectEngine *coro_tmp_engine;
 	Ink_SchedulerStack coro_scheduler_stack;
 
+	Ink_CallFrameStack frame_stack;
+
 	pthread_mutex_t thread_pool_lock;
 	ThreadIDMapStack thread_id_map_stack;
 	ThreadPool thread_pool;
@@ -134,16 +173,16 @@ public:
 	vector<DBG_TypeMapping *> dbg_type_mapping;
 	Ink_DebugTraceSet dbg_traced_set;
 
+	bool ivm_enable;
+
 	Ink_ProtocolMap protocol_map;
 
-	pthread_mutex_t message_lock;
-	Ink_ActorMessageQueue message_queue;
+	Ink_ActorMailbox mailbox;
 
 	pthread_mutex_t watcher_lock;
 	Ink_ActorWatcherList watcher_list;
 
 	Ink_CloneTraceMap deep_clone_traced_map;
-	Ink_ProtoTraceSet prototype_traced_set;
 
 	Ink_CustomInterruptSignal custom_interrupt_signal;
 
@@ -152,16 +191,24 @@ public:
 
 	Ink_ConstantTable const_table;
 
+	Ink_ImportCacheMap import_cache;
+
 	Ink_InterpreteEngine();
 
 	Ink_ContextChain_sub *addTrace(Ink_ContextObject *context);
 	void removeLastTrace();
 	void removeTrace(Ink_ContextObject *context);
+	void removeTrace(Ink_ContextChain_sub *trace_sub);
 
 	Ink_Object *findConstant(wstring name);
 	Ink_Constant *setConstant(wstring name, Ink_Object *obj);
 	void disposeConstant();
 
+	Ink_ExpressionList *findImportCache(string path, Ink_SInt64 mtime, Ink_SInt64 size);
+	void setImportCache(string path, Ink_SInt64 mtime, Ink_SInt64 size, Ink_ExpressionList exp_list);
+	void removeImportCache(string path);
+	void clearImportCache();
+
 	inline IGC_MarkType curGrey()
 	{
 		return igc_mark_period;
@@ -182,23 +229,60 @@ public:
 
 	inline void addGrey(Ink_Object *obj)
 	{
-		igc_grey_list.insert(obj);
+		igc_grey_list.push_back(obj);
 		return;
 	}
 
-	inline IGC_GreyList getGreyList()
+	inline IGC_GreyList &getGreyList()
 	{
 		return igc_grey_list;
 	}
 
-	inline void removeIfIsGrey(Ink_Object *obj)
+	/* is_literal: the value is of a numeric literal, so it's worth adding to the numeric table */
+	inline Ink_Numeric *getNumeric(Ink_NumericValue value, bool is_literal = false)
 	{
-		Ink_InterpreteEngine *engine = this;
-		IGC_GreyList::iterator iter;
-		if (IS_GREY(obj)) {
-			if ((iter = igc_grey_list.find(obj)) != igc_grey_list.end())
-				igc_grey_list.erase(iter);
+		Ink_Numeric *ret;
+
+		if (!value.isInt() || value.ival < INK_NUMERIC_CACHE_MIN
+			|| value.ival > INK_NUMERIC_CACHE_MAX) {
+			if ((ret = findNumeric(value, is_literal)) != NULL)
+				return ret;
+			return new Ink_Numeric(this, value);
 		}
+
+		if (!(ret = numeric_cache[value.ival - INK_NUMERIC_CACHE_MIN])) {
+			ret = numeric_cache[value.ival - INK_NUMERIC_CACHE_MIN]
+				= new Ink_Numeric(this, value, false);
+		}
+
+		return ret;
+	}
+
+	/* shared numerics are used by many slots at once, so they never carry an address,
+	 * a base or a debug name, see Ink_Numeric::is_shared */
+	inline bool isSharedNumeric(Ink_Object *obj)
+	{
+		return obj->type == INK_NUMERIC && as<Ink_Numeric>(obj)->is_shared;
+	}
+
+	/* the shared numeric obj got from slot is about to be worked on through its address(e.g. bonded),
+	 * so the slot gets a private copy to keep and carry the address */
+	inline Ink_Object *getAddressedNumeric(Ink_Object *obj, Ink_HashTable *slot)
+	{
+		Ink_Object *ret = new Ink_Numeric(this, as<Ink_Numeric>(obj)->getValue());
+
+		if (slot && !slot->isConstant() && slot->getValue() == obj)
+			slot->setValue(ret);
+
+		return ret;
+	}
+
+	Ink_Numeric *findNumeric(Ink_NumericValue value, bool if_add);
+	void disposeNumericCache();
+
+	inline void updateSlotEpoch()
+	{
+		slot_epoch++;
 		return;
 	}
 
@@ -216,8 +300,10 @@ public:
 	inline void applySetting(Ink_InputSetting setting)
 	{
 		igc_collect_threshold = setting.igc_collect_threshold;
+		igc_mark_budget = setting.igc_mark_budget;
 		dbg_print_detail = setting.dbg_print_detail;
 		dbg_max_trace = setting.dbg_max_trace;
+		ivm_enable = setting.ivm_enable;
 		return;
 	}
 
@@ -383,6 +469,8 @@ public:
 	}
 
 	void breakUnreachableBonding(Ink_HashTable *to_or_from);
+	/* break bondings to slots unreachable when an incremental marking ends */
+	void breakDisposableBonding();
 
 	inline int addEngineCom(Ink_ModuleID id, Ink_CustomEngineCom com)
 	{
@@ -412,18 +500,6 @@ public:
 
 	void callAllDestructor();
 
-	inline void initPrototypeSearch()
-	{
-		prototype_traced_set = Ink_ProtoTraceSet();
-		return;
-	}
-
-	inline bool /* return: if has NOT been traced */
-	addPrototypeTrace(Ink_Object *obj)
-	{
-		return prototype_traced_set.insert(obj).second;
-	}
-
 	inline void initDeepClone()
 	{
 		deep_clone_traced_map = Ink_CloneTraceMap();
@@ -489,6 +565,29 @@ public:
 		return current_gc_engine;
 	}
 
+	inline Ink_CallFrame *allocFrame()
+	{
+		Ink_CallFrame *ret;
+
+		if (frame_stack.empty()) {
+			return new Ink_CallFrame(this);
+		}
+
+		ret = frame_stack.back();
+		frame_stack.pop_back();
+		ret->gc_engine.reset();
+
+		return ret;
+	}
+
+	inline void freeFrame(Ink_CallFrame *frame)
+	{
+		frame_stack.push_back(frame);
+		return;
+	}
+
+	void disposeFrameStack();
+
 	inline void setFilePath(const char *path)
 	{
 		input_file_path = path;
@@ -529,9 +628,9 @@ public:
 	void printTrace(FILE *fp, Ink_ContextChain *context, string prefix = DBG_DEFAULT_PREFIX);
 	static const char *getNativeSignalName(Ink_InterruptSignal sig);
 
-	void startParse(Ink_InputSetting setting);
-	void startParse(FILE *input = stdin, bool close_fp = false);
-	void startParse(string code);
+	bool startParse(Ink_InputSetting setting);
+	bool startParse(FILE *input = stdin, bool close_fp = false);
+	bool startParse(string code);
 	Ink_Object *execute(Ink_ContextChain *context = NULL, bool if_trap_signal = true);
 	Ink_Object *execute(Ink_Expression *exp);
 	static void cleanExpressionList(Ink_ExpressionList exp_list);
@@ -540,6 +639,14 @@ public:
 	~Ink_InterpreteEngine();
 };
 
+/* slots of obj changed in a way that may alter the result of a lookup through it */
+inline void Ink_updateSlotEpoch(Ink_Object *obj)
+{
+	if (obj && obj->is_cache_watched && obj->engine)
+		obj->engine->updateSlotEpoch();
+	return;
+}
+
 }
 
 #endif
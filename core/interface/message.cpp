@@ -8,9 +8,7 @@ Ink_Object *Ink_InterpreteEngine::receiveMessage()
 	Ink_ActorMessage *msg = NULL;
 	Ink_InterpreteEngine *engine = this;
 
-	pthread_mutex_lock(&message_lock);
-	if (!message_queue.empty()) {
-		msg = message_queue.front();
+	if ((msg = mailbox.pop()) != NULL) {
 		ret = new Ink_Object(this);
 		ret->setSlot_c("msg", new Ink_String(this, *(msg->msg)));
 		ret->setSlot_c("sender", new Ink_String(this, *(msg->sender)));
@@ -18,36 +16,25 @@ Ink_Object *Ink_InterpreteEngine::receiveMessage()
 							 ? (Ink_Object *)msg->ex->toObject(this)
 							 : (Ink_Object *)UNDEFINED);
 		delete msg;
-		message_queue.pop();
 	}
-	pthread_mutex_unlock(&message_lock);
 	return ret;
 }
 
 void Ink_InterpreteEngine::sendInMessage(Ink_InterpreteEngine *sender, string msg, Ink_ExceptionRaw *ex)
 {
-	pthread_mutex_lock(&message_lock);
-	message_queue.push(new Ink_ActorMessage(new string(msg), InkActor_getActorName(sender), ex));
-	pthread_mutex_unlock(&message_lock);
+	mailbox.push(new Ink_ActorMessage(new string(msg), InkActor_getActorName(sender), ex));
 	return;
 }
 
 void Ink_InterpreteEngine::sendInMessage_nolock(Ink_InterpreteEngine *sender, string msg, Ink_ExceptionRaw *ex)
 {
-	pthread_mutex_lock(&message_lock);
-	message_queue.push(new Ink_ActorMessage(new string(msg), InkActor_getActorName_nolock(sender), ex));
-	pthread_mutex_unlock(&message_lock);
+	mailbox.push(new Ink_ActorMessage(new string(msg), InkActor_getActorName_nolock(sender), ex));
 	return;
 }
 
 void Ink_InterpreteEngine::disposeAllMessage()
 {
-	pthread_mutex_lock(&message_lock);
-	while (!message_queue.empty()) {
-		delete message_queue.front();
-		message_queue.pop();
-	}
-	pthread_mutex_unlock(&message_lock);
+	mailbox.clear();
 	return;
 }
 
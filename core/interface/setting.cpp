@@ -5,6 +5,7 @@
 #include "core/package/load.h"
 #include "core/gc/collect.h"
 #include "core/native/native.h"
+#include "core/coroutine/coroutine.h"
 
 namespace ink {
 
@@ -14,8 +15,10 @@ Ink_InputSetting::Ink_InputSetting(const char *input_file_path, FILE *fp, bool c
 : close_fp(close_fp), input_file_pointer(fp), code_mode(SOURCE_CODE), input_file_path(input_file_path), if_run(true)
 {
 	igc_collect_threshold = IGC_COLLECT_THRESHOLD_UNIT;
+	igc_mark_budget = 0;
 	dbg_print_detail = false;
 	dbg_max_trace = DBG_DEFAULT_MAX_TRACE;
+	ivm_enable = false;
 }
 
 inline bool isArg(const char *arg)
@@ -41,13 +44,19 @@ inline void printUsage(const char *prog_path)
 "  %-25s %s\n"
 "  %-25s %s\n"
 "  %-25s %s\n"
+"  %-25s %s\n"
+"  %-25s %s\n"
+"  %-25s %s\n"
 "  %-25s %s\n",
 	"--help or -h",							"Display this usage page",
 	"--mod-path=<path> or -m=<path>",		"Add module searching path",
 	"--gc-threshold=<threshold>",				"Set collect threshold for garbage collector",
+	"--gc-mark-budget=<count>",				"Mark at most count objects at a time so collections are done in slices, 0 means all at once",
 	"--debug or -d",						"Open debug mode(print more debug info when error occurs, optional value(true or false))",
 	"--import-path=<path> or -i=<path>",	"Add import search path(can be used several times)",
-	"--max-trace=<count>",					"Set max trace count, less than one or no argument mean print all trace");
+	"--max-trace=<count>",					"Set max trace count, less than one or no argument mean print all trace",
+	"--ivm",								"Compile expressions to bytecode before running(optional value(true or false))",
+	"--coro-stack=<size>",					"Set stack size of each coroutine in KB");
 }
 
 /* return: if print usage */
@@ -86,6 +95,21 @@ inline bool processArg(Ink_InputSetting &setting, Ink_SizeType dash_count,
 			setting.if_run = false;
 			return true;
 		}
+	} else if (IS_DOUBLE_DASH_ARG("gc-mark-budget")) {
+		if (has_val) {
+			int tmp = atoi(val.c_str());
+			if (tmp < 0) {
+				fprintf(stderr, "Failed to parsing value of option %s or it's not valid\n", REPRINT_ARG.c_str());
+				setting.if_run = false;
+				return true;
+			} else {
+				setting.igc_mark_budget = tmp;
+			}
+		} else {
+			fprintf(stderr, "Option %s requires a value\n", REPRINT_ARG.c_str());
+			setting.if_run = false;
+			return true;
+		}
 	} else if (IS_SINGLE_DASH_ARG("d") || IS_DOUBLE_DASH_ARG("debug")) {
 		if (has_val) {
 			if (val == "true") {
@@ -115,6 +139,35 @@ inline bool processArg(Ink_InputSetting &setting, Ink_SizeType dash_count,
 		} else {
 			setting.dbg_max_trace = -1;
 		}
+	} else if (IS_DOUBLE_DASH_ARG("ivm")) {
+		if (has_val) {
+			if (val == "true") {
+				setting.ivm_enable = true;
+			} else if (val == "false") {
+				setting.ivm_enable = false;
+			} else {
+				fprintf(stderr, "Unknown value given for option %s, requires boolean\n", REPRINT_ARG.c_str());
+				setting.if_run = false;
+				return true;
+			}
+		} else {
+			setting.ivm_enable = true;
+		}
+	} else if (IS_DOUBLE_DASH_ARG("coro-stack")) {
+		if (has_val) {
+			int tmp = atoi(val.c_str());
+			if (tmp <= 0) {
+				fprintf(stderr, "Failed to parsing value of option %s or it's not valid\n", REPRINT_ARG.c_str());
+				setting.if_run = false;
+				return true;
+			} else {
+				InkCoro_setStackSize((Ink_SizeType)tmp * 1024);
+			}
+		} else {
+			fprintf(stderr, "Option %s requires a value\n", REPRINT_ARG.c_str());
+			setting.if_run = false;
+			return true;
+		}
 	} else {
 		fprintf(stderr, "Unknown option %s\n", REPRINT_ARG.c_str());
 		setting.if_run = false;
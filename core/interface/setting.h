@@ -26,8 +26,10 @@ public:
 
 	/* settings */
 	IGC_ObjectCountType igc_collect_threshold;
+	IGC_ObjectCountType igc_mark_budget;
 	bool dbg_print_detail;
 	Ink_SInt32 dbg_max_trace;
+	bool ivm_enable;
 
 	Ink_InputSetting(const char *input_file_path = NULL, FILE *fp = stdin, bool close_fp = false);
 
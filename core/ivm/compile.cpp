@@ -0,0 +1,243 @@
+#include "ivm.h"
+
+namespace ink {
+
+using namespace std;
+
+inline bool isCompilable(Ink_Expression *exp)
+{
+	return as<Ink_CallExpression>(exp) || as<Ink_HashExpression>(exp)
+		   || as<Ink_LogicExpression>(exp) || as<Ink_CommaExpression>(exp);
+}
+
+IVM_Instruction &IVM_Compiler::emit(IVM_OpCode op, Ink_Expression *exp,
+									const char *file_name, Ink_LineNoType line_number)
+{
+	target->code.push_back(IVM_Instruction(op, exp, file_name, line_number));
+	return target->code.back();
+}
+
+void IVM_Compiler::push(Ink_SizeType count)
+{
+	depth += count;
+	if (depth > target->max_stack)
+		target->max_stack = depth;
+	return;
+}
+
+void IVM_Compiler::pop(Ink_SizeType count)
+{
+	depth -= count;
+	return;
+}
+
+void IVM_Compiler::compileCall(Ink_CallExpression *exp, const char *file_name, Ink_LineNoType line_number,
+							   bool check_signal)
+{
+	Ink_ArgumentList::size_type i;
+	Ink_SizeType prep;
+	bool is_slow = false;
+
+	for (i = 0; i < exp->arg_list.size(); i++) {
+		if (!exp->arg_list[i] || exp->arg_list[i]->is_expand) {
+			is_slow = true;
+			break;
+		}
+	}
+
+	compile(exp->callee, file_name, line_number, true, false);
+
+	prep = target->code.size();
+	emit(IVM_OP_PREP_CALL, exp, file_name, line_number).check_signal = check_signal;
+	push();
+
+	if (is_slow) {
+		/* arguments are left to the origin expression */
+		target->code[prep].is_slow = true;
+		for (i = 0; i < exp->arg_list.size(); i++) {
+			if (!exp->arg_list[i]) continue;
+			if (exp->arg_list[i]->arg)
+				rewrite(exp->arg_list[i]->arg);
+			if (exp->arg_list[i]->is_expand)
+				rewrite(exp->arg_list[i]->expandee);
+		}
+		pop();
+		target->code[prep].arg = target->code.size();
+		return;
+	}
+
+	for (i = 0; i < exp->arg_list.size(); i++) {
+		compile(exp->arg_list[i]->arg, file_name, line_number, true, false);
+	}
+
+	IVM_Instruction &call = emit(IVM_OP_CALL, exp, file_name, line_number);
+	call.arg = exp->arg_list.size();
+	call.check_signal = check_signal;
+	pop(exp->arg_list.size() + 1);
+
+	/* the slow path of PREP_CALL lands after CALL */
+	target->code[prep].arg = target->code.size();
+
+	return;
+}
+
+void IVM_Compiler::compile(Ink_Expression *exp, const char *file_name, Ink_LineNoType line_number,
+						   bool check_signal, bool is_root)
+{
+	/* position inside the expression */
+	const char *inner_file = exp->file_name ? exp->file_name : file_name;
+	Ink_LineNoType inner_line = exp->line_number >= 0 ? exp->line_number : line_number;
+	Ink_SizeType jump, i;
+
+	Ink_HashExpression *hash_exp;
+	Ink_IdentifierExpression *id_exp;
+	Ink_CallExpression *call_exp;
+	Ink_LogicExpression *logic_exp;
+	Ink_CommaExpression *comma_exp;
+
+	if (as<Ink_NullExpression>(exp)) {
+		emit(IVM_OP_PUSH_NULL, exp, file_name, line_number);
+		push();
+	} else if (as<Ink_UndefinedExpression>(exp)) {
+		emit(IVM_OP_PUSH_UNDEFINED, exp, file_name, line_number);
+		push();
+	} else if (as<Ink_NumericExpression>(exp)) {
+		emit(IVM_OP_PUSH_NUMERIC, exp, file_name, line_number);
+		push();
+	} else if (as<Ink_StringExpression>(exp)) {
+		emit(IVM_OP_PUSH_STRING, exp, file_name, line_number);
+		push();
+	} else if ((id_exp = as<Ink_IdentifierExpression>(exp)) != NULL) {
+		IVM_Instruction &inst = emit(IVM_OP_GET_ID, exp, inner_file, inner_line);
+		inst.check_signal = check_signal;
+		inst.use_flags = is_root;
+		push();
+	} else if ((hash_exp = as<Ink_HashExpression>(exp)) != NULL) {
+		compile(hash_exp->base, inner_file, inner_line, true, false);
+		/* slot is got after the position is restored */
+		IVM_Instruction &inst = emit(IVM_OP_GET_SLOT, exp, file_name, line_number);
+		inst.check_signal = check_signal;
+		inst.use_flags = is_root;
+	} else if ((call_exp = as<Ink_CallExpression>(exp)) != NULL) {
+		compileCall(call_exp, inner_file, inner_line, check_signal);
+	} else if ((logic_exp = as<Ink_LogicExpression>(exp)) != NULL) {
+		compile(logic_exp->lval, inner_file, inner_line, true, false);
+		jump = target->code.size();
+		emit(logic_exp->type == INK_LOGIC_AND ? IVM_OP_JUMP_IF_FALSE : IVM_OP_JUMP_IF_TRUE,
+			 exp, inner_file, inner_line);
+		emit(IVM_OP_POP, exp, inner_file, inner_line);
+		pop();
+		compile(logic_exp->rval, inner_file, inner_line, true, false);
+		target->code[jump].arg = target->code.size();
+	} else if ((comma_exp = as<Ink_CommaExpression>(exp)) != NULL) {
+		if (!comma_exp->exp_list.size()) {
+			emit(IVM_OP_PUSH_NULL, exp, inner_file, inner_line);
+			push();
+		}
+		for (i = 0; i < comma_exp->exp_list.size(); i++) {
+			if (i) {
+				emit(IVM_OP_POP, exp, inner_file, inner_line);
+				pop();
+			}
+			compile(comma_exp->exp_list[i], inner_file, inner_line, true, false);
+		}
+	} else {
+		rewriteChildren(exp);
+		IVM_Instruction &inst = emit(IVM_OP_EVAL, exp, file_name, line_number);
+		inst.check_signal = check_signal;
+		inst.use_flags = is_root;
+		push();
+	}
+
+	return;
+}
+
+void IVM_Compiler::rewriteChildren(Ink_Expression *exp)
+{
+	Ink_HashTableMapping::size_type i;
+	Ink_AssignmentExpression *assign_exp;
+	Ink_FunctionExpression *func_exp;
+	Ink_HashTableExpression *table_exp;
+	Ink_ListExpression *list_exp;
+	Ink_ArrayLiteral *arr_exp;
+	Ink_YieldExpression *yield_exp;
+	Ink_InterruptExpression *inter_exp;
+
+	/* expressions may be shared(e.g. lvalue of a += b) */
+	if (visited.find(exp) != visited.end())
+		return;
+	visited.insert(exp);
+
+	if ((assign_exp = as<Ink_AssignmentExpression>(exp)) != NULL) {
+		if (assign_exp->is_dispose_lval)
+			rewrite(assign_exp->lval);
+		rewrite(assign_exp->rval);
+	} else if ((func_exp = as<Ink_FunctionExpression>(exp)) != NULL) {
+		rewrite(func_exp->exp_list);
+	} else if ((table_exp = as<Ink_HashTableExpression>(exp)) != NULL) {
+		for (i = 0; i < table_exp->mapping.size(); i++) {
+			if (table_exp->mapping[i]->key)
+				rewrite(table_exp->mapping[i]->key);
+			rewrite(table_exp->mapping[i]->value);
+		}
+	} else if ((list_exp = as<Ink_ListExpression>(exp)) != NULL) {
+		rewrite(list_exp->elem_list);
+	} else if ((arr_exp = as<Ink_ArrayLiteral>(exp)) != NULL) {
+		rewrite(arr_exp->elem_list);
+	} else if ((yield_exp = as<Ink_YieldExpression>(exp)) != NULL) {
+		if (yield_exp->ret_val)
+			rewrite(yield_exp->ret_val);
+	} else if ((inter_exp = as<Ink_InterruptExpression>(exp)) != NULL) {
+		if (inter_exp->ret_val)
+			rewrite(inter_exp->ret_val);
+	}
+
+	return;
+}
+
+void IVM_Compiler::rewrite(Ink_Expression *&exp)
+{
+	Ink_BytecodeExpression *target_back;
+	Ink_SizeType depth_back;
+
+	if (!exp || as<Ink_BytecodeExpression>(exp))
+		return;
+
+	if (!isCompilable(exp)) {
+		rewriteChildren(exp);
+		return;
+	}
+
+	target_back = target;
+	depth_back = depth;
+
+	target = new Ink_BytecodeExpression(exp);
+	depth = 0;
+	compile(exp, NULL, -1, false, true);
+	exp = target;
+
+	target = target_back;
+	depth = depth_back;
+
+	return;
+}
+
+void IVM_Compiler::rewrite(Ink_ExpressionList &exp_list)
+{
+	Ink_ExpressionList::size_type i;
+
+	for (i = 0; i < exp_list.size(); i++) {
+		rewrite(exp_list[i]);
+	}
+
+	return;
+}
+
+void IVM_compileExpressionList(Ink_ExpressionList &exp_list)
+{
+	IVM_Compiler compiler = IVM_Compiler();
+	compiler.rewrite(exp_list);
+	return;
+}
+
+}
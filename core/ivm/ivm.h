@@ -0,0 +1,102 @@
+#ifndef _IVM_H_
+#define _IVM_H_
+
+#include <set>
+#include <vector>
+#include "../expression.h"
+
+#define IVM_LOCAL_STACK_SIZE (16)
+
+namespace ink {
+
+/* ivm -- a bytecode backend sharing the object model and native ABI with the tree-walker
+ * expressions that have no opcode are kept as they are and evaluated through IVM_OP_EVAL */
+
+enum IVM_OpCode {
+	IVM_OP_PUSH_NULL,
+	IVM_OP_PUSH_UNDEFINED,
+	IVM_OP_PUSH_NUMERIC,
+	IVM_OP_PUSH_STRING,
+	IVM_OP_GET_ID,			/* push context slot */
+	IVM_OP_GET_SLOT,		/* replace top with its slot */
+	IVM_OP_PREP_CALL,		/* pop callee, push callee & base; or call slowly and jump */
+	IVM_OP_CALL,			/* pop arguments, base & callee, push result */
+	IVM_OP_JUMP_IF_TRUE,	/* jump if top is true, keep top */
+	IVM_OP_JUMP_IF_FALSE,	/* jump if top is false, keep top */
+	IVM_OP_POP,
+	IVM_OP_EVAL				/* eval an uncompiled expression */
+};
+
+class IVM_Instruction {
+public:
+	IVM_OpCode op;
+
+	/* position the tree-walker would report, NULL/-1 for the one on entry */
+	const char *file_name;
+	Ink_LineNoType line_number;
+
+	bool check_signal;		/* return interrupt value if a signal is received */
+	bool use_flags;			/* pass eval flags of the whole expression */
+	bool is_slow;			/* call can only be done by the origin expression */
+	Ink_Expression *exp;	/* origin expression */
+	Ink_SizeType arg;		/* argc or jump target */
+
+	IVM_Instruction(IVM_OpCode op, Ink_Expression *exp, const char *file_name, Ink_LineNoType line_number)
+	: op(op), file_name(file_name), line_number(line_number), check_signal(false),
+	  use_flags(false), is_slow(false), exp(exp), arg(0)
+	{ }
+};
+
+typedef std::vector<IVM_Instruction> IVM_Code;
+
+class Ink_BytecodeExpression: public Ink_Expression {
+public:
+	Ink_Expression *origin;
+	IVM_Code code;
+	Ink_SizeType max_stack;
+
+	Ink_BytecodeExpression(Ink_Expression *origin)
+	: origin(origin), code(IVM_Code()), max_stack(0)
+	{ }
+
+	virtual Ink_Object *eval(Ink_InterpreteEngine *engine, Ink_ContextChain *context_chain, Ink_EvalFlag flags);
+	virtual bool hasIdentifier(const char **ids)
+	{
+		return origin->hasIdentifier(ids);
+	}
+
+	virtual ~Ink_BytecodeExpression()
+	{
+		delete origin;
+	}
+};
+
+class IVM_Compiler {
+	std::set<Ink_Expression *> visited;
+	Ink_BytecodeExpression *target;
+	Ink_SizeType depth;
+
+	IVM_Instruction &emit(IVM_OpCode op, Ink_Expression *exp, const char *file_name, Ink_LineNoType line_number);
+	void push(Ink_SizeType count = 1);
+	void pop(Ink_SizeType count = 1);
+
+	void compile(Ink_Expression *exp, const char *file_name, Ink_LineNoType line_number,
+				 bool check_signal, bool is_root);
+	void compileCall(Ink_CallExpression *exp, const char *file_name, Ink_LineNoType line_number,
+					 bool check_signal);
+	void rewriteChildren(Ink_Expression *exp);
+
+public:
+	IVM_Compiler()
+	: visited(std::set<Ink_Expression *>()), target(NULL), depth(0)
+	{ }
+
+	void rewrite(Ink_Expression *&exp);
+	void rewrite(Ink_ExpressionList &exp_list);
+};
+
+void IVM_compileExpressionList(Ink_ExpressionList &exp_list);
+
+}
+
+#endif
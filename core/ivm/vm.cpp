@@ -0,0 +1,145 @@
+#include <stdlib.h>
+#include "ivm.h"
+#include "core/object.h"
+#include "core/interface/engine.h"
+
+namespace ink {
+
+using namespace std;
+
+Ink_Object *Ink_BytecodeExpression::eval(Ink_InterpreteEngine *engine, Ink_ContextChain *context_chain, Ink_EvalFlag flags)
+{
+	const char *file_name_back = engine->current_file_name;
+	Ink_LineNoType line_num_back = engine->current_line_number;
+
+	Ink_Object *local_stack[IVM_LOCAL_STACK_SIZE];
+	Ink_Object **stack = local_stack;
+	Ink_Object **sp;
+	Ink_Object *func, *ret;
+	IVM_Instruction *begin = &code[0], *end = begin + code.size(), *pc = begin;
+	Ink_ArgcType argc;
+
+	if (max_stack > IVM_LOCAL_STACK_SIZE) {
+		stack = (Ink_Object **)malloc(max_stack * sizeof(Ink_Object *));
+	}
+	sp = stack;
+
+#define TOP (sp[-1])
+#define PUSH(obj) (*sp++ = (obj))
+#define FLAGS(inst) ((inst)->use_flags ? flags : Ink_EvalFlag())
+
+	while (pc != end) {
+		engine->current_file_name = pc->file_name ? pc->file_name : file_name_back;
+		engine->current_line_number = pc->line_number >= 0 ? pc->line_number : line_num_back;
+
+		switch (pc->op) {
+			case IVM_OP_PUSH_NULL:
+				PUSH(NULL_OBJ);
+				break;
+			case IVM_OP_PUSH_UNDEFINED:
+				PUSH(UNDEFINED);
+				break;
+			case IVM_OP_PUSH_NUMERIC:
+				PUSH(engine->getNumeric(static_cast<Ink_NumericExpression *>(pc->exp)->value, true));
+				break;
+			case IVM_OP_PUSH_STRING:
+				PUSH(new Ink_String(engine, *static_cast<Ink_StringExpression *>(pc->exp)->value));
+				break;
+			case IVM_OP_GET_ID: {
+				Ink_IdentifierExpression *id_exp = static_cast<Ink_IdentifierExpression *>(pc->exp);
+				PUSH(id_exp->lookup(engine, context_chain, FLAGS(pc)));
+				break;
+			}
+			case IVM_OP_GET_SLOT: {
+				Ink_HashExpression *hash_exp = static_cast<Ink_HashExpression *>(pc->exp);
+				Ink_EvalFlag slot_flags = FLAGS(pc);
+
+				slot_flags.is_addressed |= hash_exp->is_addressed;
+				TOP = Ink_HashExpression::getSlot(engine, context_chain, TOP, hash_exp->slot_sym,
+												  slot_flags, &hash_exp->cache);
+				break;
+			}
+			case IVM_OP_PREP_CALL: {
+				Ink_CallExpression *call_exp = static_cast<Ink_CallExpression *>(pc->exp);
+				Ink_ParamList::size_type i;
+				bool is_slow = pc->is_slow;
+
+				func = TOP;
+				if (!is_slow && func->type == INK_FUNCTION) {
+					/* reference parameters are sealed by the origin expression */
+					Ink_ParamList &param = as<Ink_FunctionObject>(func)->param;
+					for (i = 0; i < param.size() && i < call_exp->arg_list.size(); i++) {
+						if (param[i].is_ref) {
+							is_slow = true;
+							break;
+						}
+					}
+				}
+
+				if (is_slow) {
+					TOP = call_exp->invoke(engine, context_chain, func);
+					pc = begin + pc->arg;
+					if (pc[-1].check_signal && engine->getSignal() != INTER_NONE) {
+						ret = engine->getInterruptValue();
+						goto END;
+					}
+					continue;
+				}
+
+				if (call_exp->is_new) {
+					TOP = func = Ink_HashExpression::getSlot(engine, context_chain, func, "new");
+				}
+				PUSH(func->getBase());
+				break;
+			}
+			case IVM_OP_CALL:
+				argc = pc->arg;
+				sp -= argc + 1;
+				func = sp[-1];
+				engine->is_addressed_call = static_cast<Ink_CallExpression *>(pc->exp)->is_addressed;
+				sp[-1] = func->call(engine, context_chain, sp[0], argc, argc ? &sp[1] : NULL);
+				break;
+			case IVM_OP_JUMP_IF_TRUE:
+				if (isTrue(TOP)) {
+					pc = begin + pc->arg;
+					continue;
+				}
+				break;
+			case IVM_OP_JUMP_IF_FALSE:
+				if (!isTrue(TOP)) {
+					pc = begin + pc->arg;
+					continue;
+				}
+				break;
+			case IVM_OP_POP:
+				sp--;
+				break;
+			case IVM_OP_EVAL:
+				PUSH(pc->exp->eval(engine, context_chain, FLAGS(pc)));
+				break;
+		}
+
+		if (pc->check_signal && engine->getSignal() != INTER_NONE) {
+			ret = engine->getInterruptValue();
+			goto END;
+		}
+		pc++;
+	}
+
+#undef TOP
+#undef PUSH
+#undef FLAGS
+
+	ret = sp[-1];
+
+END:
+	engine->current_file_name = file_name_back;
+	engine->current_line_number = line_num_back;
+
+	if (stack != local_stack)
+		free(stack);
+
+	return ret;
+}
+
+}
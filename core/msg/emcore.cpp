@@ -1,7 +1,7 @@
 #include <sstream>
 #include <iostream>
 #include <string>
-#include <string>
+#include <string.h>
 #include "emcore.h"
 #include "../../includes/universal.h"
 
@@ -102,6 +102,7 @@ string Ink_ErrorMessage::formatMessage(string message, va_list args)
 {
 	string::size_type i, length;
 	string tmp = string(message);
+	const char *arg;
 
 	for (i = 0; i < tmp.length() && tmp.c_str()[i] != '\0'; i++)
 	{
@@ -112,8 +113,10 @@ string Ink_ErrorMessage::formatMessage(string message, va_list args)
 		}
 
 		for (length = 1; tmp.c_str()[i + length] != ')'; length++);
-		tmp.replace(i, length + 1, va_arg(args, const char *));
-		i += length;
+		arg = va_arg(args, const char *);
+		tmp.replace(i, length + 1, arg);
+		/* skip the inserted argument, not the placeholder(the loop adds one) */
+		i += strlen(arg) - 1;
 	}
 
 	return tmp;
@@ -1,4 +1,5 @@
 #include <vector>
+#include <algorithm>
 #include "native.h"
 #include "../object.h"
 #include "../context.h"
@@ -30,20 +31,15 @@ Ink_Object *InkNative_Array_Link(Ink_InterpreteEngine *engine, Ink_ContextChain
 		return NULL_OBJ;
 	}
 
-	Ink_ArrayValue base_val = as<Ink_Array>(base)->value;
-	Ink_ArrayValue linkee = as<Ink_Array>(argv[0])->value;
-	Ink_ArrayValue ret_val = Ink_ArrayValue(size = base_val.size() + linkee.size(), NULL);
-	Ink_Array *ret = new Ink_Array(engine, ret_val);
+	Ink_ArrayValue &base_val = as<Ink_Array>(base)->value;
+	Ink_ArrayValue &linkee = as<Ink_Array>(argv[0])->value;
+	Ink_Array *ret = new Ink_Array(engine, Ink_ArrayValue(size = base_val.size() + linkee.size()));
 
 	for (i = 0; i < size; i++) {
 		if (i < base_val.size()) {
-			if (base_val[i]) {
-				ret->value[i] = new Ink_HashTable(base_val[i]->getValue(), ret);
-			}
+			ret->setElement(i, base_val.get(i));
 		} else {
-			if (linkee[i - base_val.size()]) {
-				ret->value[i] = new Ink_HashTable(linkee[i - base_val.size()]->getValue(), ret);
-			}
+			ret->setElement(i, linkee.get(i - base_val.size()));
 		}
 	}
 
@@ -72,9 +68,13 @@ Ink_Object *InkNative_Array_Index(Ink_InterpreteEngine *engine, Ink_ContextChain
 
 	index = getRealIndex(as<Ink_Numeric>(argv[0])->getValue(), obj->value.size());
 	if (index < obj->value.size()) {
-		if (!obj->value[index]) obj->value[index] = new Ink_HashTable(UNDEFINED, obj);
-		hash = Ink_Object::traceHashBond(obj->value[index]);
+		hash = Ink_Object::traceHashBond(obj->getElementSlot(index));
 		ret = hash->getValue();
+		if (engine->isSharedNumeric(ret)) {
+			if (!engine->is_addressed_call)
+				return ret;
+			ret = engine->getAddressedNumeric(ret, hash);
+		}
 		ret->address = hash;
 		// ret->setSlot_c("base", base);
 		ret->setBase(base);
@@ -93,28 +93,60 @@ Ink_Object *InkNative_Array_Push(Ink_InterpreteEngine *engine, Ink_ContextChain
 
 	if (argc) {
 		Ink_Array *obj = as<Ink_Array>(base);
-		obj->value.push_back(new Ink_HashTable(argv[0], obj));
+		obj->pushElement(argv[0]);
 		return argv[0];
 	}
 
 	return NULL_OBJ;
 }
 
-Ink_Object *InkNative_Array_Size(Ink_InterpreteEngine *engine, Ink_ContextChain *context, Ink_Object *base, Ink_ArgcType argc, Ink_Object **argv, Ink_Object *this_p)
+Ink_Object *InkNative_Array_Pop(Ink_InterpreteEngine *engine, Ink_ContextChain *context, Ink_Object *base, Ink_ArgcType argc, Ink_Object **argv, Ink_Object *this_p)
 {
 	ASSUME_BASE_TYPE(engine, INK_ARRAY);
-	return new Ink_Numeric(engine, as<Ink_Array>(base)->value.size());
+
+	Ink_Array *obj = as<Ink_Array>(base);
+	Ink_ArrayValue::size_type size = obj->value.size();
+	Ink_Object *ret;
+
+	if (!size) return NULL_OBJ;
+
+	ret = obj->value.get(size - 1);
+	obj->removeElement(size - 1, size);
+
+	return ret ? ret : UNDEFINED;
 }
 
-void cleanArrayHashTable(Ink_ArrayValue val,
-						 Ink_ArrayValue::size_type begin,
-						 Ink_ArrayValue::size_type end) // assume that begin <= end
+Ink_Object *InkNative_Array_Shift(Ink_InterpreteEngine *engine, Ink_ContextChain *context, Ink_Object *base, Ink_ArgcType argc, Ink_Object **argv, Ink_Object *this_p)
 {
-	Ink_ArrayValue::size_type index;
-	for (index = begin; index < end; index++) {
-		delete val[index];
+	ASSUME_BASE_TYPE(engine, INK_ARRAY);
+
+	Ink_Array *obj = as<Ink_Array>(base);
+	Ink_Object *ret;
+
+	if (!obj->value.size()) return NULL_OBJ;
+
+	ret = obj->value.get(0);
+	obj->removeElement(0, 1);
+
+	return ret ? ret : UNDEFINED;
+}
+
+Ink_Object *InkNative_Array_Unshift(Ink_InterpreteEngine *engine, Ink_ContextChain *context, Ink_Object *base, Ink_ArgcType argc, Ink_Object **argv, Ink_Object *this_p)
+{
+	ASSUME_BASE_TYPE(engine, INK_ARRAY);
+
+	if (argc) {
+		as<Ink_Array>(base)->unshiftElement(argv[0]);
+		return argv[0];
 	}
-	return;
+
+	return NULL_OBJ;
+}
+
+Ink_Object *InkNative_Array_Size(Ink_InterpreteEngine *engine, Ink_ContextChain *context, Ink_Object *base, Ink_ArgcType argc, Ink_Object **argv, Ink_Object *this_p)
+{
+	ASSUME_BASE_TYPE(engine, INK_ARRAY);
+	return new Ink_Numeric(engine, as<Ink_Array>(base)->value.size());
 }
 
 Ink_Object *InkNative_Array_Each(Ink_InterpreteEngine *engine, Ink_ContextChain *context, Ink_Object *base, Ink_ArgcType argc, Ink_Object **argv, Ink_Object *this_p)
@@ -122,6 +154,7 @@ Ink_Object *InkNative_Array_Each(Ink_InterpreteEngine *engine, Ink_ContextChain
 	Ink_Array *base_arr;
 	Ink_Object **args;
 	Ink_Array *ret = NULL;
+	Ink_Object *tmp;
 	Ink_ArrayValue::size_type i;
 	IGC_CollectEngine *gc_engine = engine->getCurrentGC();
 
@@ -140,8 +173,8 @@ Ink_Object *InkNative_Array_Each(Ink_InterpreteEngine *engine, Ink_ContextChain
 	for (i = 0; i < base_arr->value.size(); i++) {
 		gc_engine->checkGC();
 
-		args[0] = base_arr->value[i] ? base_arr->value[i]->getValue() : UNDEFINED;
-		ret->value.push_back(new Ink_HashTable(argv[0]->call(engine, context, base, 1, args), ret));
+		args[0] = (tmp = base_arr->value.get(i)) ? tmp : UNDEFINED;
+		ret->pushElement(argv[0]->call(engine, context, base, 1, args));
 		if (engine->getSignal() != INTER_NONE) {
 			switch (engine->getSignal()) {
 				case INTER_RETURN:
@@ -173,6 +206,7 @@ Ink_Object *InkNative_Array_Zip(Ink_InterpreteEngine *engine, Ink_ContextChain *
 {
 	Ink_Object **args;
 	Ink_Object *block = NULL;
+	Ink_Object *tmp_obj;
 
 	Ink_Array *base_arr = NULL;
 	Ink_Array *zipee = NULL;
@@ -203,12 +237,12 @@ Ink_Object *InkNative_Array_Zip(Ink_InterpreteEngine *engine, Ink_ContextChain *
 	for (i = 0; i < base_arr->value.size(); i++) {
 		gc_engine->checkGC();
 
-		args[0] = base_arr->value[i] ? base_arr->value[i]->getValue() : UNDEFINED;
-		args[1] = (i < zipee->value.size() && zipee->value[i])
-				  ? zipee->value[i]->getValue() : UNDEFINED;
+		args[0] = (tmp_obj = base_arr->value.get(i)) ? tmp_obj : UNDEFINED;
+		args[1] = (i < zipee->value.size() && (tmp_obj = zipee->value.get(i)))
+				  ? tmp_obj : UNDEFINED;
 
 		if (block) {
-			ret->value.push_back(new Ink_HashTable(argv[1]->call(engine, context, base, 2, args), ret));
+			ret->pushElement(argv[1]->call(engine, context, base, 2, args));
 			if (engine->getSignal() != INTER_NONE) {
 				switch (engine->getSignal()) {
 					case INTER_RETURN:
@@ -230,9 +264,9 @@ Ink_Object *InkNative_Array_Zip(Ink_InterpreteEngine *engine, Ink_ContextChain *
 				}
 			}
 		} else {
-			ret->value.push_back(new Ink_HashTable(tmp = new Ink_Array(engine), ret));
-			tmp->value.push_back(new Ink_HashTable(args[0], tmp));
-			tmp->value.push_back(new Ink_HashTable(args[1], tmp));
+			ret->pushElement(tmp = new Ink_Array(engine));
+			tmp->pushElement(args[0]);
+			tmp->pushElement(args[1]);
 		}
 	}
 	free(args);
@@ -252,14 +286,14 @@ Ink_Object *InkNative_Array_Build(Ink_InterpreteEngine *engine, Ink_ContextChain
 
 	Ink_Array *base_val = as<Ink_Array>(base);
 	Ink_ArrayValue::size_type i;
-	Ink_Object *ret = base_val->value.size() ? base_val->value[0]->getValue() : NULL;
-	Ink_Object *ret_back;
+	Ink_Object *ret = base_val->value.size() ? base_val->value.get(0) : NULL;
+	Ink_Object *ret_back, *tmp;
 	Ink_FunctionObject *build_fn = as<Ink_FunctionObject>(argv[0]);
 	Ink_Object **tmp_argv = (Ink_Object **)malloc(sizeof(Ink_Object *) * 2);
 
 	for (i = 1; i < base_val->value.size(); i++) {
 		tmp_argv[0] = ret;
-		tmp_argv[1] = base_val->value[i] ? base_val->value[i]->getValue() : UNDEFINED;
+		tmp_argv[1] = (tmp = base_val->value.get(i)) ? tmp : UNDEFINED;
 		engine->addPardonObject(ret_back = ret);
 		ret = build_fn->call(engine, context, 2, tmp_argv);
 		engine->removePardonObject(ret_back);
@@ -274,16 +308,22 @@ Ink_Object *InkNative_Array_Last(Ink_InterpreteEngine *engine, Ink_ContextChain
 {
 	ASSUME_BASE_TYPE(engine, INK_ARRAY);
 
-	Ink_ArrayValue tmp = as<Ink_Array>(base)->value;
+	Ink_Array *tmp = as<Ink_Array>(base);
 	Ink_Object *ret = NULL;
-	Ink_HashTable *ret_hash = tmp[tmp.size() - 1];
+	Ink_HashTable *ret_hash;
 
-	if (!ret_hash) {
-		ret_hash = tmp[tmp.size() - 1] = new Ink_HashTable(ret = UNDEFINED, base);
-	} else {
-		ret = ret_hash->getValue();
+	if (!tmp->value.size()) {
+		InkWarn_Array_Index_Exceed(engine, 0, 0);
+		return UNDEFINED;
 	}
 
+	ret_hash = tmp->getElementSlot(tmp->value.size() - 1);
+	ret = ret_hash->getValue();
+	if (engine->isSharedNumeric(ret)) {
+		if (!engine->is_addressed_call)
+			return ret;
+		ret = engine->getAddressedNumeric(ret, ret_hash);
+	}
 	ret->address = ret_hash;
 
 	return ret;
@@ -311,7 +351,7 @@ Ink_Object *InkNative_Array_Remove(Ink_InterpreteEngine *engine, Ink_ContextChai
 								 tmp->value.size());
 	} else index_end = index_begin;
 
-	if (index_end > tmp->value.size() || index_end > tmp->value.size()) {
+	if (index_begin >= tmp->value.size() || index_end >= tmp->value.size()) {
 		InkWarn_Too_Huge_Index(engine);
 		return NULL_OBJ;
 	}
@@ -323,13 +363,10 @@ Ink_Object *InkNative_Array_Remove(Ink_InterpreteEngine *engine, Ink_ContextChai
 			index_end = tmp_val;
 		}
 		index_end++;
-		cleanArrayHashTable(tmp->value, index_begin, index_end);
-		tmp->value.erase(tmp->value.begin() + index_begin,
-						 tmp->value.begin() + index_end);
+		tmp->removeElement(index_begin, index_end);
 	} else {
-		if (tmp->value[index_begin]) ret = tmp->value[index_begin]->getValue();
-		delete tmp->value[index_begin];
-		tmp->value.erase(tmp->value.begin() + index_begin);
+		if (tmp->value.get(index_begin)) ret = tmp->value.get(index_begin);
+		tmp->removeElement(index_begin, index_begin + 1);
 	}
 
 	return ret;
@@ -340,7 +377,7 @@ Ink_Object *InkNative_Array_Slice(Ink_InterpreteEngine *engine, Ink_ContextChain
 
 	ASSUME_BASE_TYPE(engine, INK_ARRAY);
 
-	Ink_ArrayValue base_val = as<Ink_Array>(base)->value;
+	Ink_ArrayValue &base_val = as<Ink_Array>(base)->value;
 	Ink_ArrayValue::size_type start = 0, end = base_val.size() - 1, tmp, i;
 	Ink_SInt64 range = 1;
 
@@ -389,19 +426,11 @@ Ink_Object *InkNative_Array_Slice(Ink_InterpreteEngine *engine, Ink_ContextChain
 
 	if (range > 0) {
 		for (i = start; i <= end; i += range) {
-			if (base_val[i]) {
-				ret->value.push_back(new Ink_HashTable(base_val[i]->getValue(), ret));
-			} else {
-				ret->value.push_back(NULL);
-			}
+			ret->pushElement(base_val.get(i));
 		}
 	} else {
 		for (i = end; i >= start;) {
-			if (base_val[i]) {
-				ret->value.push_back(new Ink_HashTable(base_val[i]->getValue(), ret));
-			} else {
-				ret->value.push_back(NULL);
-			}
+			ret->pushElement(base_val.get(i));
 
 			if ((Ink_UInt64)-range > i) {
 				break;
@@ -428,7 +457,7 @@ Ink_Object *InkNative_Array_Rebuild(Ink_InterpreteEngine *engine, Ink_ContextCha
 	tmp = as<Ink_Array>(base);
 	ret_val = Ink_ExpressionList();
 	for (i = 0; i < tmp->value.size(); i++) {
-		if (tmp->value[i] && (tmp_obj = tmp->value[i]->getValue())) {
+		if ((tmp_obj = tmp->value.get(i)) != NULL) {
 			if (tmp_obj->type == INK_FUNCTION) {
 				tmp_func = as<Ink_FunctionObject>(tmp_obj);
 				ret_val.insert(ret_val.end(),
@@ -448,11 +477,199 @@ Ink_Object *InkNative_Array_Rebuild(Ink_InterpreteEngine *engine, Ink_ContextCha
 	return new Ink_FunctionObject(engine, Ink_ParamList(), ret_val, context->copyContextChain());
 }
 
+/* NaN is unordered under '<', so NaNs are put after all the other numbers */
+class Ink_ArraySortNumericLess {
+	std::vector<Ink_NumericValue> *keys;
+
+	static inline bool isNaN(Ink_NumericValue &val)
+	{
+		return val.isFloat() && val.fval != val.fval;
+	}
+public:
+	Ink_ArraySortNumericLess(std::vector<Ink_NumericValue> *keys)
+	: keys(keys)
+	{ }
+
+	inline bool operator () (Ink_ArrayValue::size_type a, Ink_ArrayValue::size_type b)
+	{
+		if (isNaN((*keys)[b])) return !isNaN((*keys)[a]);
+		if (isNaN((*keys)[a])) return false;
+		return (*keys)[a] < (*keys)[b];
+	}
+};
+
+/* byte order of UTF-8 is the order of code points */
+class Ink_ArraySortStringLess {
+	std::vector<const std::string *> *keys;
+public:
+	Ink_ArraySortStringLess(std::vector<const std::string *> *keys)
+	: keys(keys)
+	{ }
+
+	inline bool operator () (Ink_ArrayValue::size_type a, Ink_ArrayValue::size_type b)
+	{
+		return *(*keys)[a] < *(*keys)[b];
+	}
+};
+
+class Ink_ArraySortState {
+public:
+	Ink_InterpreteEngine *engine;
+	Ink_ContextChain *context;
+	Ink_Object *base;
+	Ink_Object *comparator; /* NULL to call '<' of the elements */
+	std::vector<Ink_Object *> *elem;
+	Ink_Object *args[2];
+	bool is_stopped;
+
+	Ink_ArraySortState(Ink_InterpreteEngine *engine, Ink_ContextChain *context, Ink_Object *base,
+					   Ink_Object *comparator, std::vector<Ink_Object *> *elem)
+	: engine(engine), context(context), base(base), comparator(comparator),
+	  elem(elem), is_stopped(false)
+	{ }
+};
+
+/* the state is shared by the copies std::stable_sort makes */
+class Ink_ArraySortCallLess {
+	Ink_ArraySortState *state;
+public:
+	Ink_ArraySortCallLess(Ink_ArraySortState *state)
+	: state(state)
+	{ }
+
+	bool operator () (Ink_ArrayValue::size_type a, Ink_ArrayValue::size_type b)
+	{
+		Ink_InterpreteEngine *engine = state->engine;
+		Ink_Object *ret, *less;
+
+		if (state->is_stopped) return false;
+		engine->getCurrentGC()->checkGC();
+
+		state->args[0] = (*state->elem)[a];
+		state->args[1] = (*state->elem)[b];
+
+		if (state->comparator) {
+			ret = state->comparator->call(engine, state->context, state->base, 2, state->args);
+		} else if ((less = getSlotWithProto(engine, state->context, state->args[0], "<"))->type == INK_FUNCTION) {
+			ret = less->call(engine, state->context, state->args[0], 1, &state->args[1]);
+		} else {
+			InkWarn_Failed_Finding_Method(engine, "<");
+			state->is_stopped = true;
+			return false;
+		}
+
+		if (engine->getSignal() != INTER_NONE) {
+			if (engine->getSignal() == INTER_CONTINUE) {
+				engine->trapSignal(); // trap the signal, take it as not less
+			} else {
+				state->is_stopped = true;
+			}
+			return false;
+		}
+
+		return ret && ret->isTrue();
+	}
+};
+
+Ink_Object *InkNative_Array_Sort(Ink_InterpreteEngine *engine, Ink_ContextChain *context, Ink_Object *base, Ink_ArgcType argc, Ink_Object **argv, Ink_Object *this_p)
+{
+	Ink_Array *obj;
+	Ink_Object *comparator = NULL, *tmp;
+	Ink_ArrayValue::size_type i, size;
+	std::vector<Ink_Object *> elem;
+	std::vector<Ink_ArrayValue::size_type> order;
+	bool is_numeric = true, is_string = true;
+
+	ASSUME_BASE_TYPE(engine, INK_ARRAY);
+
+	if (argc) {
+		if (!checkArgument(engine, argc, argv, 1, INK_FUNCTION)) {
+			return NULL_OBJ;
+		}
+		comparator = argv[0];
+	}
+
+	obj = as<Ink_Array>(base);
+	size = obj->value.size();
+
+	/* holes are moved to the end */
+	for (i = 0; i < size; i++) {
+		if ((tmp = obj->value.get(i)) != NULL) {
+			is_numeric = is_numeric && tmp->type == INK_NUMERIC;
+			is_string = is_string && tmp->type == INK_STRING;
+			order.push_back(elem.size());
+			elem.push_back(tmp);
+		}
+	}
+
+	if (!comparator && is_numeric) {
+		std::vector<Ink_NumericValue> keys;
+		keys.reserve(elem.size());
+		for (i = 0; i < elem.size(); i++) {
+			keys.push_back(as<Ink_Numeric>(elem[i])->getValue());
+		}
+		std::stable_sort(order.begin(), order.end(), Ink_ArraySortNumericLess(&keys));
+	} else if (!comparator && is_string) {
+		std::vector<const std::string *> keys;
+		keys.reserve(elem.size());
+		for (i = 0; i < elem.size(); i++) {
+			keys.push_back(&as<Ink_String>(elem[i])->getValue());
+		}
+		std::stable_sort(order.begin(), order.end(), Ink_ArraySortStringLess(&keys));
+	} else {
+		/* the comparator may drop elements from the array, so they are held by one of their own */
+		Ink_Array *hold = new Ink_Array(engine);
+		hold->value.reserve(elem.size());
+		for (i = 0; i < elem.size(); i++) {
+			hold->value.push(elem[i]);
+		}
+		engine->addPardonObject(hold);
+
+		/* merge based, so an inconsistent comparator can't run out of the range */
+		Ink_ArraySortState state = Ink_ArraySortState(engine, context, base, comparator, &elem);
+		std::stable_sort(order.begin(), order.end(), Ink_ArraySortCallLess(&state));
+
+		engine->removePardonObject(hold);
+
+		if (state.is_stopped) {
+			/* the array is left as it was */
+			switch (engine->getSignal()) {
+				case INTER_RETURN:
+					return engine->getInterruptValue(); // signal penetrated
+				case INTER_DROP:
+				case INTER_BREAK:
+					return engine->trapSignal(); // trap the signal
+				default:
+					return NULL_OBJ;
+			}
+		}
+	}
+
+	if (obj->value.size() != size) {
+		InkWarn_Array_Changed_While_Sorting(engine);
+		return base;
+	}
+
+	for (i = 0; i < size; i++) {
+		if (i < order.size()) {
+			obj->setElement(i, elem[order[i]]);
+		} else {
+			/* a slot always holds an object */
+			obj->setElement(i, obj->value.getSlot(i) ? UNDEFINED : NULL);
+		}
+	}
+
+	return base;
+}
+
 void Ink_Array::Ink_ArrayMethodInit(Ink_InterpreteEngine *engine)
 {
 	setSlot_c("+", new Ink_FunctionObject(engine, InkNative_Array_Link));
 	setSlot_c("[]", new Ink_FunctionObject(engine, InkNative_Array_Index));
 	setSlot_c("push", new Ink_FunctionObject(engine, InkNative_Array_Push));
+	setSlot_c("pop", new Ink_FunctionObject(engine, InkNative_Array_Pop));
+	setSlot_c("shift", new Ink_FunctionObject(engine, InkNative_Array_Shift));
+	setSlot_c("unshift", new Ink_FunctionObject(engine, InkNative_Array_Unshift));
 	setSlot_c("size", new Ink_FunctionObject(engine, InkNative_Array_Size));
 	setSlot_c("each", new Ink_FunctionObject(engine, InkNative_Array_Each, true));
 	setSlot_c("zip", new Ink_FunctionObject(engine, InkNative_Array_Zip, true));
@@ -460,6 +677,7 @@ void Ink_Array::Ink_ArrayMethodInit(Ink_InterpreteEngine *engine)
 	setSlot_c("last", new Ink_FunctionObject(engine, InkNative_Array_Last));
 	setSlot_c("remove", new Ink_FunctionObject(engine, InkNative_Array_Remove));
 	setSlot_c("slice", new Ink_FunctionObject(engine, InkNative_Array_Slice));
+	setSlot_c("sort", new Ink_FunctionObject(engine, InkNative_Array_Sort));
 	setSlot_c("rebuild", new Ink_FunctionObject(engine, InkNative_Array_Rebuild));
 	
 	return;
@@ -46,16 +46,19 @@ Ink_Object *InkNative_Function_Insert(Ink_InterpreteEngine *engine, Ink_ContextC
 		}
 	}
 
+	/* inserted expressions may use frame slots */
+	func->is_simple_frame = false;
+
 	return func;
 }
 
-Ink_Object **arrayValueToObjects(Ink_ArrayValue val)
+Ink_Object **arrayValueToObjects(Ink_InterpreteEngine *engine, Ink_ArrayValue &val)
 {
 	Ink_Object **ret = (Ink_Object **)malloc(sizeof(Ink_Object *) * val.size());
 	Ink_ArrayValue::size_type i;
 
 	for (i = 0; i < val.size(); i++) {
-		ret[i] = val[i]->getValue();
+		ret[i] = val.get(i) ? val.get(i) : UNDEFINED;
 	}
 
 	return ret;
@@ -63,8 +66,7 @@ Ink_Object **arrayValueToObjects(Ink_ArrayValue val)
 
 Ink_Object *InkNative_Function_RangeCall(Ink_InterpreteEngine *engine, Ink_ContextChain *context, Ink_Object *base, Ink_ArgcType argc, Ink_Object **argv, Ink_Object *this_p)
 {
-	Ink_Object *range;
-	Ink_ArrayValue range_val, tmp_arr_val;
+	Ink_Object *range, *tmp_obj;
 	Ink_Array *ret = NULL;
 	Ink_Object **tmp;
 	Ink_ArrayValue::size_type i;
@@ -96,16 +98,14 @@ Ink_Object *InkNative_Function_RangeCall(Ink_InterpreteEngine *engine, Ink_Conte
 	for (i = 0; i < as<Ink_Array>(range)->value.size(); i++) {
 		gc_engine->checkGC();
 
-		range_val = as<Ink_Array>(range)->value;
-		if (range_val[i]
-			&& range_val[i]->getValue()->type == INK_ARRAY) {
-			tmp_arr_val = as<Ink_Array>(range_val[i]->getValue())->value;
-			tmp = arrayValueToObjects(tmp_arr_val);
-			ret->value.push_back(new Ink_HashTable(base->call(engine, context, tmp_arr_val.size(), tmp), ret));
+		if ((tmp_obj = as<Ink_Array>(range)->value.get(i)) != NULL
+			&& tmp_obj->type == INK_ARRAY) {
+			tmp = arrayValueToObjects(engine, as<Ink_Array>(tmp_obj)->value);
+			ret->pushElement(base->call(engine, context, as<Ink_Array>(tmp_obj)->value.size(), tmp));
 			free(tmp);
 		} else {
 			InkWarn_Incorrect_Range_Type(engine);
-			ret->value.push_back(new Ink_HashTable(NULL_OBJ, ret));
+			ret->pushElement(NULL_OBJ);
 		}
 	}
 	engine->removePardonObject(ret);
@@ -162,7 +162,7 @@ Ink_Object *InkNative_ExpList_ToArray(Ink_InterpreteEngine *engine, Ink_ContextC
 	for (i = 0; i < tmp->exp_list.size(); i++) {
 		tmp_exp = Ink_ExpressionList();
 		tmp_exp.push_back(tmp->exp_list[i]);
-		ret->value.push_back(new Ink_HashTable(new Ink_ExpListObject(engine, tmp_exp), ret));
+		ret->pushElement(new Ink_ExpListObject(engine, tmp_exp));
 	}
 
 	return ret;
@@ -174,15 +174,6 @@ inline Ink_Object *addPackage(Ink_InterpreteEngine *engine, Ink_ContextChain *co
 	return addPackage(engine, context->getGlobal(), name, loader);
 }
 
-inline void cleanArrayHashTable(Ink_ArrayValue val)
-{
-	Ink_ArrayValue::size_type i;
-	for (i = 0; i < val.size(); i++) {
-		delete val[i];
-	}
-	return;
-}
-
 inline Ink_String *getStringVal(Ink_InterpreteEngine *engine, Ink_ContextChain *context, Ink_Object *obj)
 {
 	Ink_Object *tmp;
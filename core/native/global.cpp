@@ -1,4 +1,6 @@
 #include <stdio.h>
+#include <time.h>
+#include <sys/stat.h>
 #include "native.h"
 #include "../object.h"
 #include "../context.h"
@@ -28,24 +30,24 @@ static Ink_Object *Ink_ArrayConstructor(Ink_InterpreteEngine *engine, Ink_Contex
 	if (argc) {
 		if (argv[0]->type == INK_NUMERIC && (argc == 1 || argc == 2)) {
 			if (argc == 1) {
-				ret = new Ink_Array(engine, Ink_ArrayValue((Ink_SizeType)getInt(as<Ink_Numeric>(argv[0])->getValue()), NULL));
+				ret = new Ink_Array(engine, Ink_ArrayValue((Ink_SizeType)getInt(as<Ink_Numeric>(argv[0])->getValue())));
 			} else {
 				Ink_ArrayValue::size_type i;
-				ret = new Ink_Array(engine, Ink_ArrayValue((Ink_SizeType)getInt(as<Ink_Numeric>(argv[0])->getValue()), NULL));
+				ret = new Ink_Array(engine, Ink_ArrayValue((Ink_SizeType)getInt(as<Ink_Numeric>(argv[0])->getValue())));
 
 				for (i = 0; i < ret->value.size(); i++) {
-					ret->value[i] = new Ink_HashTable(argv[1], ret);
+					ret->setElement(i, argv[1]);
 				}
 			}
 		} else if (argv[0]->type == INK_ARRAY && argc == 1) {
 			ret = new Ink_Array(engine);
-			ret->value = Ink_Array::cloneArrayValue(as<Ink_Array>(argv[0])->value, ret);
+			ret->value = Ink_Array::cloneArrayValue(as<Ink_Array>(argv[0])->value);
 		} else {
 			Ink_ArrayValue::size_type i;
 			ret = new Ink_Array(engine);
 
 			for (i = 0; i < argc; i++) {
-				ret->value.push_back(new Ink_HashTable(argv[i], ret));
+				ret->pushElement(argv[i]);
 			}
 		}
 	} else {
@@ -69,7 +71,7 @@ static Ink_Object *Ink_Eval(Ink_InterpreteEngine *engine, Ink_ContextChain *cont
 		return ret;
 	}
 
-	InkParser_setParserInfo(1, "from eval: ");
+	InkParser_setParserInfo(engine, 1, "from eval: ");
 
 	top_level_backup = engine->top_level;
 
@@ -132,19 +134,94 @@ void Ink_addImportPath(const char *path)
 	return;
 }
 
+static bool Ink_FindImportFile(const char *current_dir, const char *name, string &full_file_name, struct stat &info)
+{
+	Ink_SizeType i;
+
+	if (!stat(name, &info)) {
+		full_file_name = string(current_dir) + INK_PATH_SPLIT + name;
+		return true;
+	}
+
+	/* cannot found in current dir, search module dir */
+	full_file_name = string(INK_MODULE_DIR) + INK_PATH_SPLIT + name;
+	if (!stat(full_file_name.c_str(), &info)) {
+		return true;
+	}
+
+	/* cannot found in module dir, search in other import paths */
+	for (i = 0; i < import_path_count; i++) {
+		full_file_name = string(import_path[i]) + INK_PATH_SPLIT + name;
+		if (!stat(full_file_name.c_str(), &info)) {
+			return true;
+		}
+	}
+
+	return false;
+}
+
+/* clock of file systems with nanosecond timestamps is only updated every tick */
+#define INK_IMPORT_MTIME_RESOLUTION (10 * 1000000)
+
+/* return: in nanoseconds */
+static Ink_SInt64 Ink_GetFileMTime(struct stat &info)
+{
+#if defined(INK_PLATFORM_WIN32)
+	return (Ink_SInt64)info.st_mtime * 1000000000;
+#else
+	return (Ink_SInt64)info.st_mtim.tv_sec * 1000000000 + info.st_mtim.tv_nsec;
+#endif
+}
+
+/* return: in nanoseconds */
+static Ink_SInt64 Ink_GetCurrentTime()
+{
+#if defined(INK_PLATFORM_WIN32)
+	return (Ink_SInt64)time(NULL) * 1000000000;
+#else
+	struct timespec ts;
+	clock_gettime(CLOCK_REALTIME, &ts);
+	return (Ink_SInt64)ts.tv_sec * 1000000000 + ts.tv_nsec;
+#endif
+}
+
+/* an edit right after the file is read may keep its mtime,
+ * so a file modified within one timestamp resolution of the read is not cached
+ * timestamps without nanoseconds are taken as whole seconds */
+static bool Ink_IsImportCacheable(Ink_SInt64 mtime, Ink_SInt64 read_time)
+{
+	Ink_SInt64 resolution = mtime % 1000000000 ? INK_IMPORT_MTIME_RESOLUTION : 1000000000;
+	return mtime + resolution <= read_time;
+}
+
+static string Ink_GetImportCacheKey(const char *path)
+{
+	char *real_path = getRealPath(path);
+	string ret = real_path ? real_path : path;
+
+	free(real_path);
+
+	return ret;
+}
+
 static Ink_Object *Ink_Import(Ink_InterpreteEngine *engine, Ink_ContextChain *context, Ink_Object *base, Ink_ArgcType argc, Ink_Object **argv, Ink_Object *this_p)
 {
 	Ink_ArgcType i;
-	Ink_SizeType j;
 	FILE *fp;
 	Ink_Object *load, **tmp_argv;
 	Ink_ExpressionList top_level_backup;
+	Ink_ExpressionList *cached;
+	Ink_ExpressionList parsed;
+	bool is_parsed;
+	Ink_SInt64 mtime, read_time;
 
 	char *current_dir = NULL, *redirect = NULL;
 	const char *file_name_backup;
 	string *tmp;
 	string *full_file_name;
 	string tmp_path;
+	string cache_key;
+	struct stat info;
 
 	for (i = 0; i < argc; i++) {
 		if (argv[i]->type == INK_STRING) {
@@ -153,30 +230,28 @@ static Ink_Object *Ink_Import(Ink_InterpreteEngine *engine, Ink_ContextChain *co
 			tmp = new string(as<Ink_String>(argv[i])->getValue());
 			current_dir = getCurrentDir();
 
-			if (!(fp = fopen(tmp->c_str(), "r"))) {
-				tmp_path = string(INK_MODULE_DIR) + INK_PATH_SPLIT + tmp->c_str();
-
-				/* cannot found in current dir, search module dir */
-				if (!(fp = fopen(tmp_path.c_str(), "r"))) {
-
-					/* cannot found in module dir, search in other import paths */
-					for (j = 0; j < import_path_count; j++) {
-						tmp_path = string(import_path[j]) + INK_PATH_SPLIT + tmp->c_str();
-						if ((fp = fopen(tmp_path.c_str(), "r")) != NULL) {
-							break;
-						}
-					}
-
-					if (!fp) {
-						InkError_Failed_Open_File(engine, tmp->c_str());
-						free(current_dir);
-						delete tmp;
-						continue;
-					}
-				}
-				full_file_name = new string(tmp_path);
-			} else {
-				full_file_name = new string(string(current_dir) + INK_PATH_SPLIT + string(tmp->c_str()));
+			if (!Ink_FindImportFile(current_dir, tmp->c_str(), tmp_path, info)) {
+				InkError_Failed_Open_File(engine, tmp->c_str());
+				free(current_dir);
+				delete tmp;
+				continue;
+			}
+			full_file_name = new string(tmp_path);
+			cache_key = Ink_GetImportCacheKey(full_file_name->c_str());
+			mtime = Ink_GetFileMTime(info);
+
+			/* parse only if the file is not cached or has been changed */
+			fp = NULL;
+			if (!(cached = engine->findImportCache(cache_key, mtime, info.st_size))) {
+				read_time = Ink_GetCurrentTime();
+				fp = fopen(full_file_name->c_str(), "r");
+			}
+			if (!cached && !fp) {
+				InkError_Failed_Open_File(engine, tmp->c_str());
+				free(current_dir);
+				delete full_file_name;
+				delete tmp;
+				continue;
 			}
 
 			/* change dir to the dest dir */
@@ -189,7 +264,7 @@ static Ink_Object *Ink_Import(Ink_InterpreteEngine *engine, Ink_ContextChain *co
 			/* backup file name, yacc prefix & lineno and set new */
 			file_name_backup = engine->getFilePath();
 			engine->setFilePath(full_file_name->c_str());
-			InkParser_setParserInfo(1, "from import: ");
+			InkParser_setParserInfo(engine, 1, "from import: ");
 
 			/* remove the last context created for import itself */
 			context->removeLast();
@@ -197,13 +272,23 @@ static Ink_Object *Ink_Import(Ink_InterpreteEngine *engine, Ink_ContextChain *co
 			/* backup original top level backup */
 			top_level_backup = engine->top_level;
 
-			/* parse and execute */
-			engine->startParse(fp);
-			engine->execute(context);
+			if (cached) {
+				/* expressions are already stored in native list */
+				engine->top_level = *cached;
+				engine->execute(context);
+			} else {
+				/* parse and execute */
+				is_parsed = engine->startParse(fp);
+				parsed = engine->top_level;
+				engine->execute(context);
+
+				/* store native expressions */
+				Ink_insertNativeExpression(parsed.begin(), parsed.end());
 
-			/* store native expressions */
-			Ink_insertNativeExpression(engine->top_level.begin(),
-									   engine->top_level.end());
+				if (is_parsed && Ink_IsImportCacheable(mtime, read_time))
+					engine->setImportCache(cache_key, mtime, info.st_size, parsed);
+				fclose(fp);
+			}
 
 			/* restore original top level */
 			engine->top_level = top_level_backup;
@@ -212,7 +297,6 @@ static Ink_Object *Ink_Import(Ink_InterpreteEngine *engine, Ink_ContextChain *co
 			context->addContext(new Ink_ContextObject(engine));
 
 			/* a few clean steps */
-			fclose(fp);
 			if (current_dir) {
 				changeDir(current_dir);
 				free(current_dir);
@@ -361,7 +445,7 @@ static Ink_Object *Ink_CoroutineCall(Ink_InterpreteEngine *engine, Ink_ContextCh
 			ret_val = NULL_OBJ;
 			goto END;
 		}
-		tmp_argv = arrayValueToObjects(as<Ink_Array>(argv[i + 1])->value);
+		tmp_argv = arrayValueToObjects(engine, as<Ink_Array>(argv[i + 1])->value);
 		co_call_list.push_back(Ink_CoCall(as<Ink_FunctionObject>(argv[i]),
 										  as<Ink_Array>(argv[i + 1])->value.size(),
 										  tmp_argv));
@@ -494,6 +578,34 @@ static Ink_Object *Ink_SetErrorMode(Ink_InterpreteEngine *engine, Ink_ContextCha
 	return TRUE_OBJ;
 }
 
+static Ink_Object *Ink_InvalidateImport(Ink_InterpreteEngine *engine, Ink_ContextChain *context, Ink_Object *base, Ink_ArgcType argc, Ink_Object **argv, Ink_Object *this_p)
+{
+	Ink_ArgcType i;
+	char *current_dir;
+	string full_file_name;
+	struct stat info;
+
+	if (!argc) {
+		engine->clearImportCache();
+		return NULL_OBJ;
+	}
+
+	current_dir = getCurrentDir();
+	for (i = 0; i < argc; i++) {
+		if (argv[i]->type != INK_STRING) {
+			InkWarn_Wrong_Argument_Type(engine, INK_STRING, argv[i]->type);
+			continue;
+		}
+		if (Ink_FindImportFile(current_dir, as<Ink_String>(argv[i])->getValue().c_str(),
+							   full_file_name, info)) {
+			engine->removeImportCache(Ink_GetImportCacheKey(full_file_name.c_str()));
+		}
+	}
+	free(current_dir);
+
+	return NULL_OBJ;
+}
+
 static Ink_Object *Ink_GetErrorMode(Ink_InterpreteEngine *engine, Ink_ContextChain *context, Ink_Object *base, Ink_ArgcType argc, Ink_Object **argv, Ink_Object *this_p)
 {
 	Ink_ErrorMode mode = engine->getErrorMode();
@@ -574,7 +686,8 @@ static Ink_ErrnoMap ink_errno_map[] = {
 	{ "FAILED_GET_CONSTANT", INK_CORE_MOD_ID, INK_EXCODE_WARN_FAILED_GET_CONSTANT },
 	{ "FIX_REQUIRE_ASSIGNABLE_ARGUMENT", INK_CORE_MOD_ID, INK_EXCODE_WARN_FIX_REQUIRE_ASSIGNABLE_ARGUMENT },
 	{ "SLICE_REQUIRE_NUMERIC", INK_CORE_MOD_ID, INK_EXCODE_WRAN_SLICE_REQUIRE_NUMERIC },
-	{ "SLICE_REQUIRE_NON_ZERO_RANGE", INK_CORE_MOD_ID, INK_EXCODE_WRAN_SLICE_REQUIRE_NON_ZERO_RANGE }
+	{ "SLICE_REQUIRE_NON_ZERO_RANGE", INK_CORE_MOD_ID, INK_EXCODE_WRAN_SLICE_REQUIRE_NON_ZERO_RANGE },
+	{ "ARRAY_CHANGED_WHILE_SORTING", INK_CORE_MOD_ID, INK_EXCODE_WARN_ARRAY_CHANGED_WHILE_SORTING }
 };
 
 void Ink_GlobalMethodInit(Ink_InterpreteEngine *engine, Ink_ContextChain *context)
@@ -602,6 +715,7 @@ void Ink_GlobalMethodInit(Ink_InterpreteEngine *engine, Ink_ContextChain *contex
 	Ink_HashTable *errmode_hash = engine_obj->setSlot_c("errmode", new Ink_String(engine, ""));
 	errmode_hash->setGetter(new Ink_FunctionObject(engine, Ink_GetErrorMode));
 	errmode_hash->setSetter(new Ink_FunctionObject(engine, Ink_SetErrorMode));
+	engine_obj->setSlot_c("invalidate_import", new Ink_FunctionObject(engine, Ink_InvalidateImport));
 	global->setSlot_c("engine", engine_obj);
 
 	Ink_Object *array_cons = new Ink_FunctionObject(engine, Ink_ArrayConstructor);
@@ -20,7 +20,7 @@ Ink_Object *InkNative_Numeric_Add(Ink_InterpreteEngine *engine, Ink_ContextChain
 		return NULL_OBJ;
 	}
 
-	return new Ink_Numeric(engine, as<Ink_Numeric>(base)->getValue() + as<Ink_Numeric>(argv[0])->getValue());
+	return engine->getNumeric(as<Ink_Numeric>(base)->getValue() + as<Ink_Numeric>(argv[0])->getValue());
 }
 
 Ink_Object *InkNative_Numeric_Sub(Ink_InterpreteEngine *engine, Ink_ContextChain *context, Ink_Object *base, Ink_ArgcType argc, Ink_Object **argv, Ink_Object *this_p)
@@ -32,7 +32,7 @@ Ink_Object *InkNative_Numeric_Sub(Ink_InterpreteEngine *engine, Ink_ContextChain
 		return NULL_OBJ;
 	}
 
-	return new Ink_Numeric(engine, as<Ink_Numeric>(base)->getValue() - as<Ink_Numeric>(argv[0])->getValue());
+	return engine->getNumeric(as<Ink_Numeric>(base)->getValue() - as<Ink_Numeric>(argv[0])->getValue());
 }
 
 Ink_Object *InkNative_Numeric_Mul(Ink_InterpreteEngine *engine, Ink_ContextChain *context, Ink_Object *base, Ink_ArgcType argc, Ink_Object **argv, Ink_Object *this_p)
@@ -44,7 +44,7 @@ Ink_Object *InkNative_Numeric_Mul(Ink_InterpreteEngine *engine, Ink_ContextChain
 		return NULL_OBJ;
 	}
 
-	return new Ink_Numeric(engine, as<Ink_Numeric>(base)->getValue() * as<Ink_Numeric>(argv[0])->getValue());
+	return engine->getNumeric(as<Ink_Numeric>(base)->getValue() * as<Ink_Numeric>(argv[0])->getValue());
 }
 
 Ink_Object *InkNative_Numeric_Div(Ink_InterpreteEngine *engine, Ink_ContextChain *context, Ink_Object *base, Ink_ArgcType argc, Ink_Object **argv, Ink_Object *this_p)
@@ -56,7 +56,7 @@ Ink_Object *InkNative_Numeric_Div(Ink_InterpreteEngine *engine, Ink_ContextChain
 		return NULL_OBJ;
 	}
 
-	return new Ink_Numeric(engine, as<Ink_Numeric>(base)->getValue() / as<Ink_Numeric>(argv[0])->getValue());
+	return engine->getNumeric(as<Ink_Numeric>(base)->getValue() / as<Ink_Numeric>(argv[0])->getValue());
 }
 
 Ink_Object *InkNative_Numeric_Mod(Ink_InterpreteEngine *engine, Ink_ContextChain *context, Ink_Object *base, Ink_ArgcType argc, Ink_Object **argv, Ink_Object *this_p)
@@ -68,7 +68,7 @@ Ink_Object *InkNative_Numeric_Mod(Ink_InterpreteEngine *engine, Ink_ContextChain
 		return NULL_OBJ;
 	}
 
-	return new Ink_Numeric(engine, as<Ink_Numeric>(base)->getValue() % as<Ink_Numeric>(argv[0])->getValue());
+	return engine->getNumeric(as<Ink_Numeric>(base)->getValue() % as<Ink_Numeric>(argv[0])->getValue());
 }
 
 /*
@@ -88,7 +88,7 @@ Ink_Object *InkNative_Numeric_And(Ink_InterpreteEngine *engine, Ink_ContextChain
 		return NULL_OBJ;
 	}
 
-	return new Ink_Numeric(engine, as<Ink_Numeric>(base)->getValue() & as<Ink_Numeric>(argv[0])->getValue());
+	return engine->getNumeric(as<Ink_Numeric>(base)->getValue() & as<Ink_Numeric>(argv[0])->getValue());
 }
 
 Ink_Object *InkNative_Numeric_Or(Ink_InterpreteEngine *engine, Ink_ContextChain *context, Ink_Object *base, Ink_ArgcType argc, Ink_Object **argv, Ink_Object *this_p)
@@ -100,7 +100,7 @@ Ink_Object *InkNative_Numeric_Or(Ink_InterpreteEngine *engine, Ink_ContextChain
 		return NULL_OBJ;
 	}
 
-	return new Ink_Numeric(engine, as<Ink_Numeric>(base)->getValue() | as<Ink_Numeric>(argv[0])->getValue());
+	return engine->getNumeric(as<Ink_Numeric>(base)->getValue() | as<Ink_Numeric>(argv[0])->getValue());
 }
 
 Ink_Object *InkNative_Numeric_Xor(Ink_InterpreteEngine *engine, Ink_ContextChain *context, Ink_Object *base, Ink_ArgcType argc, Ink_Object **argv, Ink_Object *this_p)
@@ -112,7 +112,7 @@ Ink_Object *InkNative_Numeric_Xor(Ink_InterpreteEngine *engine, Ink_ContextChain
 		return NULL_OBJ;
 	}
 
-	return new Ink_Numeric(engine, as<Ink_Numeric>(base)->getValue() ^ as<Ink_Numeric>(argv[0])->getValue());
+	return engine->getNumeric(as<Ink_Numeric>(base)->getValue() ^ as<Ink_Numeric>(argv[0])->getValue());
 }
 
 Ink_Object *InkNative_Numeric_ShiftLeft(Ink_InterpreteEngine *engine, Ink_ContextChain *context, Ink_Object *base, Ink_ArgcType argc, Ink_Object **argv, Ink_Object *this_p)
@@ -124,7 +124,7 @@ Ink_Object *InkNative_Numeric_ShiftLeft(Ink_InterpreteEngine *engine, Ink_Contex
 		return NULL_OBJ;
 	}
 
-	return new Ink_Numeric(engine, as<Ink_Numeric>(base)->getValue() << as<Ink_Numeric>(argv[0])->getValue());
+	return engine->getNumeric(as<Ink_Numeric>(base)->getValue() << as<Ink_Numeric>(argv[0])->getValue());
 }
 
 Ink_Object *InkNative_Numeric_ShiftRight(Ink_InterpreteEngine *engine, Ink_ContextChain *context, Ink_Object *base, Ink_ArgcType argc, Ink_Object **argv, Ink_Object *this_p)
@@ -136,7 +136,7 @@ Ink_Object *InkNative_Numeric_ShiftRight(Ink_InterpreteEngine *engine, Ink_Conte
 		return NULL_OBJ;
 	}
 
-	return new Ink_Numeric(engine, as<Ink_Numeric>(base)->getValue() >> as<Ink_Numeric>(argv[0])->getValue());
+	return engine->getNumeric(as<Ink_Numeric>(base)->getValue() >> as<Ink_Numeric>(argv[0])->getValue());
 }
 
 Ink_Object *InkNative_Numeric_Inverse(Ink_InterpreteEngine *engine, Ink_ContextChain *context, Ink_Object *base, Ink_ArgcType argc, Ink_Object **argv, Ink_Object *this_p)
@@ -144,7 +144,7 @@ Ink_Object *InkNative_Numeric_Inverse(Ink_InterpreteEngine *engine, Ink_ContextC
 
 	ASSUME_BASE_TYPE(engine, INK_NUMERIC);
 
-	return new Ink_Numeric(engine, ~(as<Ink_Numeric>(base)->getValue()));
+	return engine->getNumeric(~(as<Ink_Numeric>(base)->getValue()));
 }
 
 Ink_Object *InkNative_Numeric_Spaceship(Ink_InterpreteEngine *engine, Ink_ContextChain *context, Ink_Object *base, Ink_ArgcType argc, Ink_Object **argv, Ink_Object *this_p)
@@ -156,7 +156,7 @@ Ink_Object *InkNative_Numeric_Spaceship(Ink_InterpreteEngine *engine, Ink_Contex
 		return NULL_OBJ;
 	}
 
-	return new Ink_Numeric(engine, as<Ink_Numeric>(base)->getValue() - as<Ink_Numeric>(argv[0])->getValue());
+	return engine->getNumeric(as<Ink_Numeric>(base)->getValue() - as<Ink_Numeric>(argv[0])->getValue());
 }
 
 Ink_Object *InkNative_Numeric_Equal(Ink_InterpreteEngine *engine, Ink_ContextChain *context, Ink_Object *base, Ink_ArgcType argc, Ink_Object **argv, Ink_Object *this_p)
@@ -169,7 +169,7 @@ Ink_Object *InkNative_Numeric_Equal(Ink_InterpreteEngine *engine, Ink_ContextCha
 		return InkNative_Object_Equal(engine, context, base, argc, argv, this_p);
 	}
 
-	return new Ink_Numeric(engine, as<Ink_Numeric>(base)->getValue() == as<Ink_Numeric>(argv[0])->getValue());
+	return engine->getNumeric(as<Ink_Numeric>(base)->getValue() == as<Ink_Numeric>(argv[0])->getValue());
 }
 
 Ink_Object *InkNative_Numeric_NotEqual(Ink_InterpreteEngine *engine, Ink_ContextChain *context, Ink_Object *base, Ink_ArgcType argc, Ink_Object **argv, Ink_Object *this_p)
@@ -182,7 +182,7 @@ Ink_Object *InkNative_Numeric_NotEqual(Ink_InterpreteEngine *engine, Ink_Context
 		return InkNative_Object_NotEqual(engine, context, base, argc, argv, this_p);
 	}
 
-	return new Ink_Numeric(engine, as<Ink_Numeric>(base)->getValue() != as<Ink_Numeric>(argv[0])->getValue());
+	return engine->getNumeric(as<Ink_Numeric>(base)->getValue() != as<Ink_Numeric>(argv[0])->getValue());
 }
 
 Ink_Object *InkNative_Numeric_Greater(Ink_InterpreteEngine *engine, Ink_ContextChain *context, Ink_Object *base, Ink_ArgcType argc, Ink_Object **argv, Ink_Object *this_p)
@@ -194,7 +194,7 @@ Ink_Object *InkNative_Numeric_Greater(Ink_InterpreteEngine *engine, Ink_ContextC
 		return NULL_OBJ;
 	}
 
-	return new Ink_Numeric(engine, as<Ink_Numeric>(base)->getValue() > as<Ink_Numeric>(argv[0])->getValue());
+	return engine->getNumeric(as<Ink_Numeric>(base)->getValue() > as<Ink_Numeric>(argv[0])->getValue());
 }
 
 Ink_Object *InkNative_Numeric_Less(Ink_InterpreteEngine *engine, Ink_ContextChain *context, Ink_Object *base, Ink_ArgcType argc, Ink_Object **argv, Ink_Object *this_p)
@@ -206,7 +206,7 @@ Ink_Object *InkNative_Numeric_Less(Ink_InterpreteEngine *engine, Ink_ContextChai
 		return NULL_OBJ;
 	}
 
-	return new Ink_Numeric(engine, as<Ink_Numeric>(base)->getValue() < as<Ink_Numeric>(argv[0])->getValue());
+	return engine->getNumeric(as<Ink_Numeric>(base)->getValue() < as<Ink_Numeric>(argv[0])->getValue());
 }
 
 Ink_Object *InkNative_Numeric_GreaterOrEqual(Ink_InterpreteEngine *engine, Ink_ContextChain *context, Ink_Object *base, Ink_ArgcType argc, Ink_Object **argv, Ink_Object *this_p)
@@ -218,7 +218,7 @@ Ink_Object *InkNative_Numeric_GreaterOrEqual(Ink_InterpreteEngine *engine, Ink_C
 		return NULL_OBJ;
 	}
 
-	return new Ink_Numeric(engine, as<Ink_Numeric>(base)->getValue() >= as<Ink_Numeric>(argv[0])->getValue());
+	return engine->getNumeric(as<Ink_Numeric>(base)->getValue() >= as<Ink_Numeric>(argv[0])->getValue());
 }
 
 Ink_Object *InkNative_Numeric_LessOrEqual(Ink_InterpreteEngine *engine, Ink_ContextChain *context, Ink_Object *base, Ink_ArgcType argc, Ink_Object **argv, Ink_Object *this_p)
@@ -230,7 +230,7 @@ Ink_Object *InkNative_Numeric_LessOrEqual(Ink_InterpreteEngine *engine, Ink_Cont
 		return NULL_OBJ;
 	}
 
-	return new Ink_Numeric(engine, as<Ink_Numeric>(base)->getValue() <= as<Ink_Numeric>(argv[0])->getValue());
+	return engine->getNumeric(as<Ink_Numeric>(base)->getValue() <= as<Ink_Numeric>(argv[0])->getValue());
 }
 
 Ink_Object *InkNative_Numeric_Add_Unary(Ink_InterpreteEngine *engine, Ink_ContextChain *context, Ink_Object *base, Ink_ArgcType argc, Ink_Object **argv, Ink_Object *this_p)
@@ -238,7 +238,7 @@ Ink_Object *InkNative_Numeric_Add_Unary(Ink_InterpreteEngine *engine, Ink_Contex
 
 	ASSUME_BASE_TYPE(engine, INK_NUMERIC);
 
-	return new Ink_Numeric(engine, as<Ink_Numeric>(base)->getValue());
+	return engine->getNumeric(as<Ink_Numeric>(base)->getValue());
 }
 
 Ink_Object *InkNative_Numeric_Sub_Unary(Ink_InterpreteEngine *engine, Ink_ContextChain *context, Ink_Object *base, Ink_ArgcType argc, Ink_Object **argv, Ink_Object *this_p)
@@ -246,7 +246,7 @@ Ink_Object *InkNative_Numeric_Sub_Unary(Ink_InterpreteEngine *engine, Ink_Contex
 
 	ASSUME_BASE_TYPE(engine, INK_NUMERIC);
 
-	return new Ink_Numeric(engine, -as<Ink_Numeric>(base)->getValue());
+	return engine->getNumeric(-as<Ink_Numeric>(base)->getValue());
 }
 
 Ink_Object *InkNative_Numeric_Not_Postfix(Ink_InterpreteEngine *engine, Ink_ContextChain *context, Ink_Object *base, Ink_ArgcType argc, Ink_Object **argv, Ink_Object *this_p)
@@ -258,7 +258,7 @@ Ink_Object *InkNative_Numeric_Not_Postfix(Ink_InterpreteEngine *engine, Ink_Cont
 	Ink_NumericValue ret, i;
 	for (i = 1, ret = 1; i <= val; i++) ret = ret * i;
 
-	return new Ink_Numeric(engine, ret);
+	return engine->getNumeric(ret);
 }
 
 Ink_Object *InkNative_Numeric_ToString(Ink_InterpreteEngine *engine, Ink_ContextChain *context, Ink_Object *base, Ink_ArgcType argc, Ink_Object **argv, Ink_Object *this_p)
@@ -274,7 +274,7 @@ Ink_Object *InkNative_Numeric_Ceil(Ink_InterpreteEngine *engine, Ink_ContextChai
 
 	ASSUME_BASE_TYPE(engine, INK_NUMERIC);
 
-	return new Ink_Numeric(engine, as<Ink_Numeric>(base)->getValue().ceil());
+	return engine->getNumeric(as<Ink_Numeric>(base)->getValue().ceil());
 }
 
 Ink_Object *InkNative_Numeric_Floor(Ink_InterpreteEngine *engine, Ink_ContextChain *context, Ink_Object *base, Ink_ArgcType argc, Ink_Object **argv, Ink_Object *this_p)
@@ -282,7 +282,7 @@ Ink_Object *InkNative_Numeric_Floor(Ink_InterpreteEngine *engine, Ink_ContextCha
 
 	ASSUME_BASE_TYPE(engine, INK_NUMERIC);
 
-	return new Ink_Numeric(engine, as<Ink_Numeric>(base)->getValue().floor());
+	return engine->getNumeric(as<Ink_Numeric>(base)->getValue().floor());
 }
 
 Ink_Object *InkNative_Numeric_Round(Ink_InterpreteEngine *engine, Ink_ContextChain *context, Ink_Object *base, Ink_ArgcType argc, Ink_Object **argv, Ink_Object *this_p)
@@ -290,7 +290,7 @@ Ink_Object *InkNative_Numeric_Round(Ink_InterpreteEngine *engine, Ink_ContextCha
 
 	ASSUME_BASE_TYPE(engine, INK_NUMERIC);
 
-	return new Ink_Numeric(engine, as<Ink_Numeric>(base)->getValue().round());
+	return engine->getNumeric(as<Ink_Numeric>(base)->getValue().round());
 }
 
 Ink_Object *InkNative_Numeric_Trunc(Ink_InterpreteEngine *engine, Ink_ContextChain *context, Ink_Object *base, Ink_ArgcType argc, Ink_Object **argv, Ink_Object *this_p)
@@ -298,7 +298,7 @@ Ink_Object *InkNative_Numeric_Trunc(Ink_InterpreteEngine *engine, Ink_ContextCha
 
 	ASSUME_BASE_TYPE(engine, INK_NUMERIC);
 
-	return new Ink_Numeric(engine, getInt(as<Ink_Numeric>(base)->getValue()));
+	return engine->getNumeric(getInt(as<Ink_Numeric>(base)->getValue()));
 }
 
 Ink_Object *InkNative_Numeric_Abs(Ink_InterpreteEngine *engine, Ink_ContextChain *context, Ink_Object *base, Ink_ArgcType argc, Ink_Object **argv, Ink_Object *this_p)
@@ -306,7 +306,7 @@ Ink_Object *InkNative_Numeric_Abs(Ink_InterpreteEngine *engine, Ink_ContextChain
 
 	ASSUME_BASE_TYPE(engine, INK_NUMERIC);
 
-	return new Ink_Numeric(engine, as<Ink_Numeric>(base)->getValue().abs());
+	return engine->getNumeric(as<Ink_Numeric>(base)->getValue().abs());
 }
 
 Ink_Object *InkNative_Numeric_IsNan(Ink_InterpreteEngine *engine, Ink_ContextChain *context, Ink_Object *base, Ink_ArgcType argc, Ink_Object **argv, Ink_Object *this_p)
@@ -314,7 +314,7 @@ Ink_Object *InkNative_Numeric_IsNan(Ink_InterpreteEngine *engine, Ink_ContextCha
 
 	ASSUME_BASE_TYPE(engine, INK_NUMERIC);
 
-	return new Ink_Numeric(engine, isnan((long double)getFloat(as<Ink_Numeric>(base)->getValue())));
+	return engine->getNumeric(isnan((long double)getFloat(as<Ink_Numeric>(base)->getValue())));
 }
 
 Ink_Object *InkNative_Numeric_IsInf(Ink_InterpreteEngine *engine, Ink_ContextChain *context, Ink_Object *base, Ink_ArgcType argc, Ink_Object **argv, Ink_Object *this_p)
@@ -322,7 +322,7 @@ Ink_Object *InkNative_Numeric_IsInf(Ink_InterpreteEngine *engine, Ink_ContextCha
 
 	ASSUME_BASE_TYPE(engine, INK_NUMERIC);
 
-	return new Ink_Numeric(engine, isinf((long double)getFloat(as<Ink_Numeric>(base)->getValue())));
+	return engine->getNumeric(isinf((long double)getFloat(as<Ink_Numeric>(base)->getValue())));
 }
 
 Ink_Object *InkNative_Numeric_IsInt(Ink_InterpreteEngine *engine, Ink_ContextChain *context, Ink_Object *base, Ink_ArgcType argc, Ink_Object **argv, Ink_Object *this_p)
@@ -330,7 +330,7 @@ Ink_Object *InkNative_Numeric_IsInt(Ink_InterpreteEngine *engine, Ink_ContextCha
 
 	ASSUME_BASE_TYPE(engine, INK_NUMERIC);
 
-	return new Ink_Numeric(engine, (int)as<Ink_Numeric>(base)->getValue().isInt());
+	return engine->getNumeric((int)as<Ink_Numeric>(base)->getValue().isInt());
 }
 
 Ink_Object *InkNative_Numeric_IsFloat(Ink_InterpreteEngine *engine, Ink_ContextChain *context, Ink_Object *base, Ink_ArgcType argc, Ink_Object **argv, Ink_Object *this_p)
@@ -338,7 +338,7 @@ Ink_Object *InkNative_Numeric_IsFloat(Ink_InterpreteEngine *engine, Ink_ContextC
 
 	ASSUME_BASE_TYPE(engine, INK_NUMERIC);
 
-	return new Ink_Numeric(engine, (int)as<Ink_Numeric>(base)->getValue().isFloat());
+	return engine->getNumeric((int)as<Ink_Numeric>(base)->getValue().isFloat());
 }
 
 Ink_Object *InkNative_Numeric_Times(Ink_InterpreteEngine *engine, Ink_ContextChain *context, Ink_Object *base, Ink_ArgcType argc, Ink_Object **argv, Ink_Object *this_p)
@@ -356,15 +356,15 @@ Ink_Object *InkNative_Numeric_Times(Ink_InterpreteEngine *engine, Ink_ContextCha
 	}
 
 	to = as<Ink_Numeric>(base)->getValue();
-	ret = new Ink_Array(engine, Ink_ArrayValue((Ink_UInt64)getInt(to), NULL));
+	ret = new Ink_Array(engine, Ink_ArrayValue((Ink_UInt64)getInt(to)));
 	engine->addPardonObject(ret);
 
 	args = (Ink_Object **)malloc(sizeof(Ink_Object *));
 	for (i = 0; i < to; i++) {
 		gc_engine->checkGC();
 		if (block) {
-			args[0] = new Ink_Numeric(engine, i);
-			ret->value[getInt(i)] = new Ink_HashTable(argv[0]->call(engine, context, base, 1, args), ret);
+			args[0] = engine->getNumeric(i);
+			ret->setElement(getInt(i), argv[0]->call(engine, context, base, 1, args));
 			if (engine->getSignal() != INTER_NONE) {
 				switch (engine->getSignal()) {
 					case INTER_RETURN:
@@ -386,7 +386,7 @@ Ink_Object *InkNative_Numeric_Times(Ink_InterpreteEngine *engine, Ink_ContextCha
 				}
 			}
 		} else {
-			ret->value[getInt(i)] = new Ink_HashTable(new Ink_Numeric(engine, i), ret);
+			ret->setElement(getInt(i), engine->getNumeric(i));
 		}
 	}
 
@@ -47,7 +47,9 @@ bool isEqual(Ink_Object *a, Ink_Object *b)
 		return as<Ink_Numeric>(a)->getValue() == as<Ink_Numeric>(b)->getValue();
 	}
 	if (a->type == INK_STRING) {
-		return as<Ink_String>(a)->getValue() == as<Ink_String>(b)->getValue();
+		/* lengths are known without flattening a rope */
+		return as<Ink_String>(a)->getLength() == as<Ink_String>(b)->getLength()
+			   && as<Ink_String>(a)->getValue() == as<Ink_String>(b)->getValue();
 	}
 	if (a->type == INK_UNDEFINED && b->type == INK_UNDEFINED) return true;
 	if (a->type == INK_NULL && b->type == INK_NULL) return true;
@@ -67,15 +69,14 @@ Ink_Object *InkNative_Object_NotEqual(Ink_InterpreteEngine *engine, Ink_ContextC
 
 Ink_Object *InkNative_Object_Index(Ink_InterpreteEngine *engine, Ink_ContextChain *context, Ink_Object *base, Ink_ArgcType argc, Ink_Object **argv, Ink_Object *this_p)
 {
-	string tmp;
-
 	if (!checkArgument(engine, argc, argv, 1, INK_STRING)) {
 		return NULL_OBJ;
 	}
 
-	tmp = as<Ink_String>(argv[0])->getValue();
+	Ink_EvalFlag flags = Ink_EvalFlag();
+	flags.is_addressed = engine->is_addressed_call;
 
-	return getSlotWithProto(engine, context, base, tmp.c_str());
+	return Ink_HashExpression::getSlot(engine, context, base, as<Ink_String>(argv[0])->getValue().c_str(), flags);
 }
 
 Ink_Object *InkNative_Object_New(Ink_InterpreteEngine *engine, Ink_ContextChain *context, Ink_Object *base, Ink_ArgcType argc, Ink_Object **argv, Ink_Object *this_p)
@@ -157,8 +158,6 @@ Ink_Object *InkNative_Object_SetSetter(Ink_InterpreteEngine *engine, Ink_Context
 	return NULL_OBJ;
 }
 
-void cleanArrayHashTable(Ink_ArrayValue val);
-
 Ink_Object *InkNative_Object_Each(Ink_InterpreteEngine *engine, Ink_ContextChain *context, Ink_Object *base, Ink_ArgcType argc, Ink_Object **argv, Ink_Object *this_p)
 {
 	Ink_Object **args;
@@ -182,7 +181,7 @@ Ink_Object *InkNative_Object_Each(Ink_InterpreteEngine *engine, Ink_ContextChain
 
 		args[0] = new Ink_String(engine, string(hash->key));
 		args[1] = hash->getValue() ? hash->getValue() : UNDEFINED;
-		ret->value.push_back(new Ink_HashTable(ret_tmp = argv[0]->call(engine, context, base, 2, args), ret));
+		ret->pushElement(ret_tmp = argv[0]->call(engine, context, base, 2, args));
 		if (engine->getSignal() != INTER_NONE) {
 			switch (engine->getSignal()) {
 				case INTER_RETURN:
@@ -31,7 +31,11 @@ Ink_Object *InkNative_String_Add(Ink_InterpreteEngine *engine, Ink_ContextChain
 	}
 
 	if ((tmp = getStringVal(engine, context, argv[0])) != NULL) {
-		return new Ink_String(engine, as<Ink_String>(base)->getWValue() + tmp->getWValue());
+		if (as<Ink_String>(base)->getLength() + tmp->getLength() >= INK_STRING_ROPE_MIN_LENGTH) {
+			/* flattened when it's read */
+			return new Ink_String(engine, as<Ink_String>(base), tmp);
+		}
+		return new Ink_String(engine, as<Ink_String>(base)->getValue() + tmp->getValue());
 	}
 
 	InkWarn_Invalid_Argument_For_String_Add(engine, argv[0]->type);
@@ -40,8 +44,8 @@ Ink_Object *InkNative_String_Add(Ink_InterpreteEngine *engine, Ink_ContextChain
 
 Ink_Object *InkNative_String_Index(Ink_InterpreteEngine *engine, Ink_ContextChain *context, Ink_Object *base, Ink_ArgcType argc, Ink_Object **argv, Ink_Object *this_p)
 {
-	wstring base_str;
-	wstring::size_type index;
+	Ink_String *base_str;
+	Ink_SizeType index;
 
 	ASSUME_BASE_TYPE(engine, INK_STRING);
 
@@ -56,15 +60,15 @@ Ink_Object *InkNative_String_Index(Ink_InterpreteEngine *engine, Ink_ContextChai
 		return InkNative_Object_Index(engine, context, base, argc, argv, this_p);
 	}
 
-	base_str = as<Ink_String>(base)->getWValue();
-	index = getRealIndex(as<Ink_Numeric>(argv[0])->getValue(), base_str.length());
+	base_str = as<Ink_String>(base);
+	index = getRealIndex(as<Ink_Numeric>(argv[0])->getValue(), base_str->getCodeLength());
 
-	if (index >= base_str.length()) {
-		InkWarn_String_Index_Exceed(engine, index, base_str.length());
+	if (index >= base_str->getCodeLength()) {
+		InkWarn_String_Index_Exceed(engine, index, base_str->getCodeLength());
 		return NULL_OBJ;
 	}
 
-	return new Ink_String(engine, base_str.substr(index, 1));
+	return new Ink_String(engine, base_str->getCodeSubStr(index, 1));
 }
 
 Ink_Object *InkNative_String_Char(Ink_InterpreteEngine *engine, Ink_ContextChain *context, Ink_Object *base, Ink_ArgcType argc, Ink_Object **argv, Ink_Object *this_p)
@@ -72,19 +76,19 @@ Ink_Object *InkNative_String_Char(Ink_InterpreteEngine *engine, Ink_ContextChain
 
 	ASSUME_BASE_TYPE(engine, INK_STRING);
 
-	wstring base_val = as<Ink_String>(base)->getWValue();
-	wstring::size_type i = 0;
+	Ink_String *base_str = as<Ink_String>(base);
+	Ink_SizeType i = 0;
 
 	if (argc && argv[0]->type == INK_NUMERIC) {
 		i = getInt(as<Ink_Numeric>(argv[0])->getValue());
 	}
 
-	if (i >= base_val.length()) {
-		InkWarn_String_Index_Exceed(engine, i, base_val.length());
+	if (i >= base_str->getCodeLength()) {
+		InkWarn_String_Index_Exceed(engine, i, base_str->getCodeLength());
 		return NULL_OBJ;
 	}
 
-	return new Ink_Numeric(engine, base_val[i]);
+	return new Ink_Numeric(engine, base_str->getCodeAt(i));
 }
 
 Ink_Object *InkNative_String_Length(Ink_InterpreteEngine *engine, Ink_ContextChain *context, Ink_Object *base, Ink_ArgcType argc, Ink_Object **argv, Ink_Object *this_p)
@@ -92,13 +96,13 @@ Ink_Object *InkNative_String_Length(Ink_InterpreteEngine *engine, Ink_ContextCha
 
 	ASSUME_BASE_TYPE(engine, INK_STRING);
 
-	return new Ink_Numeric(engine, (Ink_SInt64)as<Ink_String>(base)->getWValue().length());
+	return new Ink_Numeric(engine, (Ink_SInt64)as<Ink_String>(base)->getCodeLength());
 }
 
 Ink_Object *InkNative_String_SubStr(Ink_InterpreteEngine *engine, Ink_ContextChain *context, Ink_Object *base, Ink_ArgcType argc, Ink_Object **argv, Ink_Object *this_p)
 {
-	wstring::size_type offset;
-	wstring::size_type length;
+	Ink_SizeType offset;
+	Ink_SizeType length;
 
 	ASSUME_BASE_TYPE(engine, INK_STRING);
 
@@ -106,24 +110,24 @@ Ink_Object *InkNative_String_SubStr(Ink_InterpreteEngine *engine, Ink_ContextCha
 		return NULL_OBJ;
 	}
 
-	wstring origin = as<Ink_String>(base)->getWValue();
+	Ink_String *origin = as<Ink_String>(base);
 	if (argc > 1 && argv[1]->type == INK_NUMERIC) {
-		offset = getRealIndex(as<Ink_Numeric>(argv[0])->getValue(), origin.length());
+		offset = getRealIndex(as<Ink_Numeric>(argv[0])->getValue(), origin->getCodeLength());
 		length = getInt(as<Ink_Numeric>(argv[1])->getValue());
 	} else {
-		offset = getRealIndex(as<Ink_Numeric>(argv[0])->getValue(), origin.length());
-		length = string::npos;
+		offset = getRealIndex(as<Ink_Numeric>(argv[0])->getValue(), origin->getCodeLength());
+		length = (Ink_SizeType)-1;
 	}
 
-	if (offset >= origin.length()) {
-		InkWarn_String_Index_Exceed(engine, offset, origin.length());
+	if (offset >= origin->getCodeLength()) {
+		InkWarn_String_Index_Exceed(engine, offset, origin->getCodeLength());
 		return NULL_OBJ;
-	} else if (!(length == string::npos || offset + length <= origin.length())) {
+	} else if (!(length == (Ink_SizeType)-1 || offset + length <= origin->getCodeLength())) {
 		InkWarn_Sub_String_Exceed(engine);
 		return NULL_OBJ;
 	}
 
-	return new Ink_String(engine, origin.substr(offset, length));
+	return new Ink_String(engine, origin->getCodeSubStr(offset, length));
 }
 
 Ink_Object *InkNative_String_Split(Ink_InterpreteEngine *engine, Ink_ContextChain *context, Ink_Object *base, Ink_ArgcType argc, Ink_Object **argv, Ink_Object *this_p)
@@ -142,17 +146,17 @@ Ink_Object *InkNative_String_Split(Ink_InterpreteEngine *engine, Ink_ContextChai
 
 	for (i = 0, last = 0; i < base_str.size(); i++) {
 		if (base_str.substr(i, split.length()) == split) {
-			ret->value.push_back(new Ink_HashTable(new Ink_String(engine, tmp = (i > last
-																	   ? base_str.substr(last, i - last)
-																	   : L"")), ret));
+			ret->pushElement(new Ink_String(engine, tmp = (i > last
+														   ? base_str.substr(last, i - last)
+														   : L"")));
 			last = i + split.length();
 			i += split.length() - 1;
 		}
 	}
 
-	ret->value.push_back(new Ink_HashTable(new Ink_String(engine, i > last
-														  ? base_str.substr(last, i - last)
-														  : L""), ret));
+	ret->pushElement(new Ink_String(engine, i > last
+											  ? base_str.substr(last, i - last)
+											  : L""));
 
 	return ret;
 }
@@ -239,8 +243,8 @@ Ink_Object *InkNative_String_Greater(Ink_InterpreteEngine *engine, Ink_ContextCh
 		return NULL_OBJ;
 	}
 
-	return new Ink_Numeric(engine, as<Ink_String>(base)->getWValue()[0]
-								   > as<Ink_String>(argv[0])->getWValue()[0]);
+	return new Ink_Numeric(engine, as<Ink_String>(base)->getCodeAt(0)
+								   > as<Ink_String>(argv[0])->getCodeAt(0));
 }
 
 Ink_Object *InkNative_String_Less(Ink_InterpreteEngine *engine, Ink_ContextChain *context, Ink_Object *base, Ink_ArgcType argc, Ink_Object **argv, Ink_Object *this_p)
@@ -251,8 +255,8 @@ Ink_Object *InkNative_String_Less(Ink_InterpreteEngine *engine, Ink_ContextChain
 		return NULL_OBJ;
 	}
 
-	return new Ink_Numeric(engine, as<Ink_String>(base)->getWValue()[0]
-								   < as<Ink_String>(argv[0])->getWValue()[0]);
+	return new Ink_Numeric(engine, as<Ink_String>(base)->getCodeAt(0)
+								   < as<Ink_String>(argv[0])->getCodeAt(0));
 }
 
 Ink_Object *InkNative_String_GreaterOrEqual(Ink_InterpreteEngine *engine, Ink_ContextChain *context, Ink_Object *base, Ink_ArgcType argc, Ink_Object **argv, Ink_Object *this_p)
@@ -263,8 +267,8 @@ Ink_Object *InkNative_String_GreaterOrEqual(Ink_InterpreteEngine *engine, Ink_Co
 		return NULL_OBJ;
 	}
 
-	return new Ink_Numeric(engine, as<Ink_String>(base)->getWValue()[0]
-								   >= as<Ink_String>(argv[0])->getWValue()[0]);
+	return new Ink_Numeric(engine, as<Ink_String>(base)->getCodeAt(0)
+								   >= as<Ink_String>(argv[0])->getCodeAt(0));
 }
 
 Ink_Object *InkNative_String_LessOrEqual(Ink_InterpreteEngine *engine, Ink_ContextChain *context, Ink_Object *base, Ink_ArgcType argc, Ink_Object **argv, Ink_Object *this_p)
@@ -275,8 +279,8 @@ Ink_Object *InkNative_String_LessOrEqual(Ink_InterpreteEngine *engine, Ink_Conte
 		return NULL_OBJ;
 	}
 
-	return new Ink_Numeric(engine, as<Ink_String>(base)->getWValue()[0]
-								   <= as<Ink_String>(argv[0])->getWValue()[0]);
+	return new Ink_Numeric(engine, as<Ink_String>(base)->getCodeAt(0)
+								   <= as<Ink_String>(argv[0])->getCodeAt(0));
 }
 
 Ink_Object *InkNative_String_ToArray(Ink_InterpreteEngine *engine, Ink_ContextChain *context, Ink_Object *base, Ink_ArgcType argc, Ink_Object **argv, Ink_Object *this_p)
@@ -287,11 +291,10 @@ Ink_Object *InkNative_String_ToArray(Ink_InterpreteEngine *engine, Ink_ContextCh
 	wstring base_val = as<Ink_String>(base)->getWValue();
 	wstring::size_type len = base_val.length();
 	Ink_SizeType i;
-	Ink_ArrayValue ret_val = Ink_ArrayValue(len, NULL);
-	Ink_Array *ret = new Ink_Array(engine, ret_val);
+	Ink_Array *ret = new Ink_Array(engine, Ink_ArrayValue(len));
 
 	for (i = 0; i < len; i++) {
-		ret->value[i] = new Ink_HashTable(new Ink_Numeric(engine, base_val[i]), ret);
+		ret->setElement(i, new Ink_Numeric(engine, base_val[i]));
 	}
 
 	return ret;
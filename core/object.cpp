@@ -1,6 +1,7 @@
 #include <string.h>
 #include "hash.h"
 #include "object.h"
+#include "expression.h"
 #include "interface/engine.h"
 #include "native/native.h"
 
@@ -36,6 +37,7 @@ void Ink_Object::setProto(Ink_Object *proto)
 		proto_hash->setValue(proto);
 	} else {
 		proto_hash = new Ink_HashTable("prototype", proto, this);
+		Ink_updateSlotEpoch(this);
 	}
 
 	IGC_CHECK_WRITE_BARRIER(this, proto);
@@ -43,6 +45,229 @@ void Ink_Object::setProto(Ink_Object *proto)
 	return;
 }
 
+/* slots set by the function call itself, the resolver never addresses them */
+static inline bool isFrameSlotName(const char *key)
+{
+	return !strcmp(key, "base") || !strcmp(key, "this")
+		   || !strcmp(key, "self") || !strcmp(key, "let");
+}
+
+void Ink_ContextObject::registerFrameSlot(Ink_HashTable *slot)
+{
+	Ink_SInt32 index;
+
+	if (!frame_scope)
+		return;
+
+	/* frame names are interned at parse time, owned keys never match them */
+	if (slot->is_key_interned && (index = frame_scope->findSymbol(slot->key)) >= 0) {
+		/* the first node of a key is the one found by name */
+		if (index < INK_FRAME_SLOT_COUNT && !frame_slot[index])
+			frame_slot[index] = slot;
+	} else if (!isFrameSlotName(slot->key)) {
+		has_extra_slot = true;
+	}
+
+	return;
+}
+
+void Ink_String::concat(Ink_String *left, Ink_String *right)
+{
+	rope_length = left->getLength() + right->getLength();
+
+	/* appending to a longer string(e.g. s = s + x in a loop) extends its buffer in amortized O(1) */
+	if (!left->left && left->getLength() >= right->getLength()) {
+		extend(left, right);
+		return;
+	}
+
+	this->left = left;
+	this->right = right;
+	rope_depth = (left->rope_depth > right->rope_depth ? left->rope_depth : right->rope_depth) + 1;
+	if (rope_depth > INK_STRING_ROPE_MAX_DEPTH)
+		flatten();
+
+	return;
+}
+
+void Ink_String::extend(Ink_String *str, Ink_String *tail)
+{
+	std::string tmp;
+	const std::string *tail_value;
+
+	if (!str->buffer) {
+		/* str hands its value over to a new buffer and keeps the whole of it as the prefix */
+		str->buffer = new Ink_StringBuffer();
+		str->buffer->value.swap(*str->value);
+		str->buffer->ref_count = 1;
+		str->rope_length = str->buffer->value.length();
+		delete str->value;
+		str->value = NULL;
+	}
+
+	if (tail->buffer == str->buffer) {
+		/* e.g. s + s, the tail is read before the buffer changes */
+		tmp.assign(tail->buffer->value, 0, tail->rope_length);
+		tail_value = &tmp;
+	} else {
+		tail_value = &tail->getValue();
+	}
+
+	if (str->buffer->value.length() == str->rope_length) {
+		buffer = str->buffer;
+	} else {
+		/* a longer string has extended the buffer already, so str is copied */
+		buffer = new Ink_StringBuffer();
+		buffer->value.reserve(rope_length);
+		buffer->value.append(str->buffer->value, 0, str->rope_length);
+	}
+	buffer->value.append(*tail_value);
+	buffer->ref_count++;
+
+	return;
+}
+
+void Ink_String::unshareBuffer()
+{
+	if (buffer->ref_count == 1) {
+		value = new std::string();
+		value->swap(buffer->value);
+		value->resize(rope_length);
+		delete buffer;
+	} else {
+		value = new std::string(buffer->value, 0, rope_length);
+		buffer->ref_count--;
+	}
+	buffer = NULL;
+	rope_length = 0;
+
+	return;
+}
+
+void Ink_String::flatten()
+{
+	std::vector<Ink_String *> stack;
+	Ink_String *cur;
+	std::string *ret = new std::string();
+
+	ret->reserve(rope_length);
+
+	/* a rope made by a loop is as deep as the loop is long, so it's not walked recursively */
+	stack.push_back(right);
+	stack.push_back(left);
+	while (!stack.empty()) {
+		cur = stack.back();
+		stack.pop_back();
+		if (cur->left) {
+			stack.push_back(cur->right);
+			stack.push_back(cur->left);
+		} else if (cur->buffer) {
+			ret->append(cur->buffer->value, 0, cur->rope_length);
+		} else {
+			ret->append(cur->getValue());
+		}
+	}
+
+	value = ret;
+	left = right = NULL;
+	rope_length = 0;
+	rope_depth = 0;
+
+	return;
+}
+
+/* return: bytes of the code point at str, invalid bytes are taken one by one */
+inline std::string::size_type Ink_String_codeSize(const char *str, std::string::size_type max, wchar_t *ret)
+{
+	mbstate_t ps;
+	size_t status;
+
+	memset(&ps, 0, sizeof(mbstate_t));
+	status = mbrtowc(ret, str, max, &ps);
+	if (status == 0 || status == (size_t)-1 || status == (size_t)-2) {
+		if (ret) *ret = (unsigned char)*str;
+		return 1;
+	}
+
+	return status;
+}
+
+void Ink_String::buildIndex()
+{
+	const std::string &str = getValue();
+	std::string::size_type i, len = str.length();
+	Ink_SizeType count;
+
+	index = new Ink_StringIndex();
+
+	for (i = 0; i < len && !(str[i] & 0x80); i++) ;
+	if (i == len) {
+		index->code_length = len;
+		return;
+	}
+
+	index->is_ascii = false;
+	for (i = 0, count = 0; i < len; count++) {
+		if (count % INK_STRING_INDEX_STEP == 0)
+			index->offset.push_back(i);
+		i += Ink_String_codeSize(&str[i], len - i, NULL);
+	}
+	index->code_length = count;
+
+	return;
+}
+
+std::string::size_type Ink_String::getCodeOffset(Ink_SizeType i)
+{
+	const std::string &str = getValue();
+	std::string::size_type ret;
+	Ink_SizeType left;
+
+	if (!index) buildIndex();
+	if (index->is_ascii) return i;
+	if (i >= index->code_length) return str.length();
+
+	ret = index->offset[i / INK_STRING_INDEX_STEP];
+	for (left = i % INK_STRING_INDEX_STEP; left; left--) {
+		ret += Ink_String_codeSize(&str[ret], str.length() - ret, NULL);
+	}
+
+	return ret;
+}
+
+wchar_t Ink_String::getCodeAt(Ink_SizeType i)
+{
+	std::string::size_type offset;
+	wchar_t ret;
+
+	if (i >= getCodeLength())
+		return 0;
+
+	offset = getCodeOffset(i);
+	Ink_String_codeSize(&getValue()[offset], getValue().length() - offset, &ret);
+
+	return ret;
+}
+
+std::string Ink_String::getCodeSubStr(Ink_SizeType i, Ink_SizeType length)
+{
+	std::string::size_type begin = getCodeOffset(i);
+
+	if (length > getCodeLength() - i)
+		return getValue().substr(begin);
+
+	return getValue().substr(begin, getCodeOffset(i + length) - begin);
+}
+
+void Ink_String::doSelfMark(Ink_InterpreteEngine *engine, IGC_Marker marker)
+{
+	if (left) {
+		marker(engine, left);
+		marker(engine, right);
+	}
+	return;
+}
+
 Ink_Object *Ink_ContextObject::setReturnVal(Ink_Object *obj)
 {
 	ret_val = obj;
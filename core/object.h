@@ -2,19 +2,23 @@
 #define _OBJECT_H_
 
 #include <string.h>
+#include <new>
 #include <vector>
 #include <string>
 #include "type.h"
 #include "hash.h"
+#include "symbol.h"
 #include "general.h"
 #include "constant.h"
 #include "error.h"
 #include "utf8.h"
 #include "coroutine/coroutine.h"
+#include "gc/alloc.h"
 
 namespace ink {
 
 class Ink_Expression;
+class Ink_LexicalScope;
 class Ink_ContextObject;
 class Ink_ContextChain;
 class IGC_CollectEngine;
@@ -22,6 +26,18 @@ class Ink_InterpreteEngine;
 
 void IGC_addObject(Ink_InterpreteEngine *current_engine, Ink_Object *obj);
 
+/* links an object into the chains of a collect engine, embedded in the object */
+class IGC_CollectUnit {
+public:
+	IGC_CollectUnit *prev;
+	Ink_Object *obj;
+	IGC_CollectUnit *next;
+
+	IGC_CollectUnit(Ink_Object *obj)
+	: prev(NULL), obj(obj), next(NULL)
+	{ }
+};
+
 class Ink_Object {
 public:
 	IGC_MarkType mark;
@@ -29,30 +45,39 @@ public:
 	Ink_TypeTag type;
 
 	Ink_HashTable *hash_table;
+	Ink_HashIndex *hash_index;
 	Ink_HashTable *address;
 
-	char *debug_name;
+	const char *debug_name; /* interned, or owned if is_debug_name_owned */
+	bool is_debug_name_owned;
 
 	Ink_InterpreteEngine *engine;
+	IGC_CollectUnit gc_unit;
 
 	Ink_HashTable *proto_hash;
 	Ink_Object *base_p;
 
-	Ink_Object(Ink_InterpreteEngine *engine)
-	: engine(engine)
+	/* some inline cache holds a slot found through this object */
+	bool is_cache_watched;
+
+	Ink_Object(Ink_InterpreteEngine *engine, bool if_collect = true)
+	: engine(engine), gc_unit(this)
 	{
 		mark = MARK_WHITE; // IGC_Mark_White;
 		// age = 0;
 		type = INK_OBJECT;
 		hash_table = NULL;
+		hash_index = NULL;
 		address = NULL;
 		debug_name = NULL;
+		is_debug_name_owned = false;
 		proto_hash = NULL;
 		base_p = NULL;
+		is_cache_watched = false;
 		
 		initProto(engine);
 
-		if (engine)
+		if (engine && if_collect)
 			IGC_addObject(engine, this);
 		// initMethod();
 	}
@@ -102,9 +127,25 @@ public:
 
 	inline void setDebugName(const char *name)
 	{
-		if (debug_name)
-			free(debug_name);
-		debug_name = name ? strdup(name) : NULL;
+		const char *sym;
+
+		if (name == debug_name)
+			return;
+
+		if (is_debug_name_owned) {
+			free((void *)debug_name);
+			is_debug_name_owned = false;
+		}
+
+		if (!name) {
+			debug_name = NULL;
+		} else if ((sym = InkSymbol_find(name)) != NULL) {
+			debug_name = sym;
+		} else {
+			debug_name = strdup(name);
+			is_debug_name_owned = true;
+		}
+
 		return;
 	}
 
@@ -125,6 +166,11 @@ public:
 		return getSlotMapping(engine, key, NULL, search_prototype);
 	}
 
+	/* own slot with a value, getter or setter */
+	Ink_HashTable *findSlot(const char *key, const char *sym);
+	Ink_HashTable *findLastSlot(const char *key, const char *sym, bool if_check_exist, Ink_HashTable **last);
+	void appendSlot(Ink_HashTable *slot, Ink_HashTable *last);
+
 	Ink_HashTable *setSlot(const char *key, Ink_Object *value, bool if_check_exist = true, bool if_alloc_key = true);
 	Ink_HashTable *setSlot(const char *key, Ink_InterpreteEngine *engine, Ink_Constant *value, bool if_check_exist = true, bool if_alloc_key = true);
 
@@ -175,10 +221,24 @@ public:
 		return NULL;
 	}
 
+	static inline void *operator new(size_t size)
+	{
+		void *ret = IGC_allocate(size);
+		if (!ret) throw std::bad_alloc();
+		return ret;
+	}
+
+	static inline void operator delete(void *ptr, size_t size)
+	{
+		IGC_free(ptr, size);
+		return;
+	}
+
 	virtual ~Ink_Object()
 	{
 		cleanHashTable();
-		free(debug_name);
+		if (is_debug_name_owned)
+			free((void *)debug_name);
 	}
 };
 
@@ -225,23 +285,41 @@ public:
 	}
 };
 
+#define INK_FRAME_SLOT_COUNT 8
+
 class Ink_ContextObject: public Ink_Object {
 	Ink_Object *ret_val;
 
+	/* base & function of a simple frame, marked as the unset frame slots would be */
+	Ink_Object *frame_base;
+	Ink_Object *frame_self;
+
 public:
 	const char *debug_file_name;
 	Ink_LineNoType debug_lineno;
 	Ink_Object *debug_creator;
 
+	/* scope of the function owning the context, slots it declares are kept in frame_slot */
+	Ink_LexicalScope *frame_scope;
+	Ink_HashTable *frame_slot[INK_FRAME_SLOT_COUNT];
+	/* some slot not declared by the scope exists, it may hide outer names */
+	bool has_extra_slot;
+
 	Ink_ContextObject(Ink_InterpreteEngine *engine)
 	: Ink_Object(engine)
 	{
 		type = INK_CONTEXT;
 		ret_val = NULL;
+		frame_base = NULL;
+		frame_self = NULL;
 
 		debug_file_name = NULL;
 		debug_lineno = -1;
 		debug_creator = NULL;
+
+		frame_scope = NULL;
+		memset(frame_slot, 0, sizeof(frame_slot));
+		has_extra_slot = false;
 	}
 	Ink_ContextObject(Ink_InterpreteEngine *engine, Ink_HashTable *hash)
 	: Ink_Object(engine)
@@ -249,10 +327,16 @@ public:
 		type = INK_CONTEXT;
 		hash_table = hash;
 		ret_val = NULL;
+		frame_base = NULL;
+		frame_self = NULL;
 
 		debug_file_name = NULL;
 		debug_lineno = -1;
 		debug_creator = NULL;
+
+		frame_scope = NULL;
+		memset(frame_slot, 0, sizeof(frame_slot));
+		has_extra_slot = false;
 	}
 
 	virtual Ink_Object *clone(Ink_InterpreteEngine *engine);
@@ -264,6 +348,31 @@ public:
 	virtual void doSelfMark(Ink_InterpreteEngine *engine, IGC_Marker marker)
 	{
 		marker(engine, ret_val);
+		marker(engine, frame_base);
+		marker(engine, frame_self);
+		return;
+	}
+
+	inline void setFrame(Ink_Object *base, Ink_Object *self)
+	{
+		frame_base = base;
+		frame_self = self;
+		return;
+	}
+
+	/* must be set before any slot is created */
+	inline void setFrameScope(Ink_LexicalScope *scope)
+	{
+		frame_scope = scope;
+		return;
+	}
+
+	void registerFrameSlot(Ink_HashTable *slot);
+
+	inline void resetFrameSlot()
+	{
+		memset(frame_slot, 0, sizeof(frame_slot));
+		has_extra_slot = false;
 		return;
 	}
 
@@ -306,6 +415,8 @@ public:
 	bool is_native;
 	bool is_inline;
 	bool is_ref;
+	bool is_simple_frame; /* frame slots are never used by the body */
+	Ink_LexicalScope *scope; /* scope of the local contexts */
 
 	Ink_NativeFunction native;
 
@@ -325,7 +436,7 @@ public:
 
 	Ink_FunctionObject(Ink_InterpreteEngine *engine)
 	: Ink_Object(engine),
-	  is_native(false), is_inline(false), is_ref(false), native(NULL),
+	  is_native(false), is_inline(false), is_ref(false), is_simple_frame(false), scope(NULL), native(NULL),
 	  param(Ink_ParamList()), exp_list(Ink_ExpressionList()), closure_context(NULL),
 	  attr(Ink_FunctionAttribution()), is_pa(false), pa_argc(0), pa_argv(NULL), pa_info_base_p(NULL), pa_info_this_p(NULL),
 	  pa_info_if_return_this(false)
@@ -336,7 +447,7 @@ public:
 
 	Ink_FunctionObject(Ink_InterpreteEngine *engine, Ink_NativeFunction native, bool is_inline = false)
 	: Ink_Object(engine),
-	  is_native(true), is_inline(is_inline), is_ref(false), native(native),
+	  is_native(true), is_inline(is_inline), is_ref(false), is_simple_frame(false), scope(NULL), native(native),
 	  param(Ink_ParamList()), exp_list(Ink_ExpressionList()), closure_context(NULL),
 	  attr(Ink_FunctionAttribution()), is_pa(false), pa_argc(0), pa_argv(NULL), pa_info_base_p(NULL), pa_info_this_p(NULL),
 	  pa_info_if_return_this(false)
@@ -350,7 +461,7 @@ public:
 
 	Ink_FunctionObject(Ink_InterpreteEngine *engine, Ink_NativeFunction native, Ink_ParamList param)
 	: Ink_Object(engine),
-	  is_native(true), is_inline(false), is_ref(false), native(native),
+	  is_native(true), is_inline(false), is_ref(false), is_simple_frame(false), scope(NULL), native(native),
 	  param(param), exp_list(Ink_ExpressionList()), closure_context(NULL),
 	  attr(Ink_FunctionAttribution()), is_pa(false), pa_argc(0), pa_argv(NULL), pa_info_base_p(NULL), pa_info_this_p(NULL),
 	  pa_info_if_return_this(false)
@@ -366,7 +477,7 @@ public:
 					   Ink_ParamList param, Ink_ExpressionList exp_list, Ink_ContextChain *closure_context,
 					   bool is_inline = false, bool is_ref = false)
 	: Ink_Object(engine),
-	  is_native(false), is_inline(is_inline), is_ref(is_ref), native(NULL),
+	  is_native(false), is_inline(is_inline), is_ref(is_ref), is_simple_frame(false), scope(NULL), native(NULL),
 	  param(param), exp_list(exp_list), closure_context(closure_context), attr(Ink_FunctionAttribution()),
 	  is_pa(false), pa_argc(0), pa_argv(NULL), pa_info_base_p(NULL), pa_info_this_p(NULL), pa_info_if_return_this(false)
 	{
@@ -484,12 +595,21 @@ public:
 	virtual Ink_Object *cloneDeep(Ink_InterpreteEngine *engine);
 };
 
+/* small integers are shared per engine and live outside the gc chain */
+#define INK_NUMERIC_CACHE_MIN (-128)
+#define INK_NUMERIC_CACHE_MAX (1024)
+#define INK_NUMERIC_CACHE_SIZE (INK_NUMERIC_CACHE_MAX - INK_NUMERIC_CACHE_MIN + 1)
+/* other values of literals(doubles mostly), a power of 2 and kept at most half full */
+#define INK_NUMERIC_TABLE_SIZE (1024)
+
 class Ink_Numeric: public Ink_Object {
 	Ink_NumericValue value;
 public:
+	/* numerics out of the gc chain are the ones shared by the engine */
+	bool is_shared;
 
-	Ink_Numeric(Ink_InterpreteEngine *engine, Ink_NumericValue value)
-	: Ink_Object(engine), value(value)
+	Ink_Numeric(Ink_InterpreteEngine *engine, Ink_NumericValue value, bool if_collect = true)
+	: Ink_Object(engine, if_collect), value(value), is_shared(!if_collect)
 	{
 		type = INK_NUMERIC;
 		initProto(engine);
@@ -519,44 +639,109 @@ public:
 	}
 };
 
+/* shorter concatenations are copied right away */
+#define INK_STRING_ROPE_MIN_LENGTH 256
+/* deeper ropes are flattened as they're made, which bounds the nodes the collector walks */
+#define INK_STRING_ROPE_MAX_DEPTH 512
+
+/* multibyte form shared by a string and the ones appended to it,
+ * each of them is a prefix of it, so only the longest one may extend it in place */
+class Ink_StringBuffer {
+public:
+	std::string value;
+	Ink_SizeType ref_count;
+
+	Ink_StringBuffer()
+	: value(std::string()), ref_count(0)
+	{ }
+};
+
+/* code points between two entries of Ink_StringIndex::offset */
+#define INK_STRING_INDEX_STEP 64
+
+/* finds code points in the multibyte form without converting all of it */
+class Ink_StringIndex {
+public:
+	bool is_ascii; /* then byte offsets are code point indexes, offset is empty */
+	Ink_SizeType code_length;
+	/* byte offset of every INK_STRING_INDEX_STEP-th code point */
+	std::vector<std::string::size_type> offset;
+
+	Ink_StringIndex()
+	: is_ascii(true), code_length(0), offset(std::vector<std::string::size_type>())
+	{ }
+};
+
 class Ink_String: public Ink_Object {
-	// std::string *value;
-	std::wstring *value;
+	/* the multibyte(UTF-8) form, wide strings are converted as they're made */
+	std::string *value;
+	/* built when a code point is first looked for */
+	Ink_StringIndex *index;
+	/* pieces of a rope not flattened yet, value is NULL until it is */
+	Ink_String *left;
+	Ink_String *right;
+	/* or the first rope_length bytes of buffer, copied to value when read */
+	Ink_StringBuffer *buffer;
+	std::string::size_type rope_length;
+	Ink_SizeType rope_depth;
+
+	void concat(Ink_String *left, Ink_String *right);
+	void extend(Ink_String *str, Ink_String *tail);
+	void flatten();
+	void unshareBuffer();
+	void buildIndex();
+
+	static std::string *toMultibyte(const std::wstring &v)
+	{
+		char *tmp = Ink_wcstombs_alloc(v.c_str());
+		std::string *ret = new std::string(tmp);
+
+		free(tmp);
+		return ret;
+	}
 public:
 
 	Ink_String(Ink_InterpreteEngine *engine, std::wstring v)
-	: Ink_Object(engine), value(new std::wstring(v))
+	: Ink_Object(engine), value(toMultibyte(v)), index(NULL),
+	  left(NULL), right(NULL), buffer(NULL), rope_length(0), rope_depth(0)
 	{
 		type = INK_STRING;
 		initProto(engine);
 	}
 
 	Ink_String(Ink_InterpreteEngine *engine, std::wstring *v)
-	: Ink_Object(engine), value(v)
+	: Ink_Object(engine), value(toMultibyte(*v)), index(NULL),
+	  left(NULL), right(NULL), buffer(NULL), rope_length(0), rope_depth(0)
 	{
 		type = INK_STRING;
 		initProto(engine);
+		delete v;
 	}
 
 	Ink_String(Ink_InterpreteEngine *engine, std::string v)
-	: Ink_Object(engine)
+	: Ink_Object(engine), value(new std::string(v)), index(NULL),
+	  left(NULL), right(NULL), buffer(NULL), rope_length(0), rope_depth(0)
 	{
 		type = INK_STRING;
 		initProto(engine);
-		wchar_t *tmp = Ink_mbstowcs_alloc(v.c_str());
-		value = new std::wstring(tmp);
-		free(tmp);
 	}
 
 	Ink_String(Ink_InterpreteEngine *engine, std::string *v)
-	: Ink_Object(engine)
+	: Ink_Object(engine), value(v), index(NULL),
+	  left(NULL), right(NULL), buffer(NULL), rope_length(0), rope_depth(0)
 	{
 		type = INK_STRING;
 		initProto(engine);
-		wchar_t *tmp = Ink_mbstowcs_alloc(v->c_str());
-		value = new std::wstring(tmp);
-		free(tmp);
-		delete v;
+	}
+
+	/* concatenation of the two, made without copying the longer one */
+	Ink_String(Ink_InterpreteEngine *engine, Ink_String *left, Ink_String *right)
+	: Ink_Object(engine), value(NULL), index(NULL),
+	  left(NULL), right(NULL), buffer(NULL), rope_length(0), rope_depth(0)
+	{
+		type = INK_STRING;
+		initProto(engine);
+		concat(left, right);
 	}
 
 	virtual void derivedMethodInit(Ink_InterpreteEngine *engine)
@@ -565,19 +750,43 @@ public:
 	}
 	void Ink_StringMethodInit(Ink_InterpreteEngine *engine);
 
-	inline std::string getValue()
+	/* return: length of the multibyte form */
+	inline std::string::size_type getLength()
+	{
+		return left || buffer ? rope_length : getValue().length();
+	}
+
+	inline const std::string &getValue()
+	{
+		if (left) flatten();
+		if (buffer) unshareBuffer();
+		return *value;
+	}
+
+	/* return: a converted copy, for the uses walking all code points */
+	inline std::wstring getWValue()
 	{
-		char *tmp = Ink_wcstombs_alloc(value->c_str());
-		std::string ret = std::string(tmp);
+		wchar_t *tmp = Ink_mbstowcs_alloc(getValue().c_str());
+		std::wstring ret = std::wstring(tmp);
+
 		free(tmp);
 		return ret;
 	}
 
-	inline std::wstring getWValue()
+	/* return: length in code points */
+	inline Ink_SizeType getCodeLength()
 	{
-		return *value;
+		if (!index) buildIndex();
+		return index->code_length;
 	}
 
+	/* return: byte offset of the code point i, the end of the string if i is the length */
+	std::string::size_type getCodeOffset(Ink_SizeType i);
+	/* return: the code point i, 0 if out of range */
+	wchar_t getCodeAt(Ink_SizeType i);
+	/* return: multibyte form of length code points from the code point i */
+	std::string getCodeSubStr(Ink_SizeType i, Ink_SizeType length = (Ink_SizeType)-1);
+
 	virtual Ink_Object *clone(Ink_InterpreteEngine *engine);
 	virtual Ink_Object *cloneDeep(Ink_InterpreteEngine *engine);
 	virtual bool isTrue()
@@ -590,9 +799,102 @@ public:
 		return new Ink_StringConstant(getWValue());
 	}
 
+	virtual void doSelfMark(Ink_InterpreteEngine *engine, IGC_Marker marker);
+
 	virtual ~Ink_String()
 	{
 		delete value;
+		delete index;
+		if (buffer && !--buffer->ref_count)
+			delete buffer;
+	}
+};
+
+/* element of an array, kept as the object itself until a slot is needed for it */
+class Ink_ArrayElement {
+public:
+	Ink_Object *value;
+	Ink_HashTable *slot; /* created once the element is indexed, then it holds the value */
+
+	Ink_ArrayElement(Ink_Object *value = NULL)
+	: value(value), slot(NULL)
+	{ }
+};
+
+#define INK_ARRAY_MIN_FRONT_GAP 8
+
+/* elements live in [head, elem.size()), so both ends can grow or shrink in amortized O(1) */
+class Ink_ArrayValue {
+	std::vector<Ink_ArrayElement> elem;
+	std::vector<Ink_ArrayElement>::size_type head;
+
+public:
+	typedef std::vector<Ink_ArrayElement>::size_type size_type;
+
+	Ink_ArrayValue()
+	: elem(), head(0)
+	{ }
+
+	/* size holes */
+	Ink_ArrayValue(size_type size)
+	: elem(size), head(0)
+	{ }
+
+	inline size_type size()
+	{
+		return elem.size() - head;
+	}
+
+	/* return: NULL for a hole */
+	inline Ink_Object *get(size_type i)
+	{
+		Ink_ArrayElement &e = elem[head + i];
+		return e.slot ? e.slot->getValue() : e.value;
+	}
+
+	inline bool isHole(size_type i)
+	{
+		return !elem[head + i].slot && !elem[head + i].value;
+	}
+
+	inline Ink_HashTable *getSlot(size_type i)
+	{
+		return elem[head + i].slot;
+	}
+
+	/* the slot takes over the value */
+	inline void setSlot(size_type i, Ink_HashTable *slot)
+	{
+		elem[head + i].value = NULL;
+		elem[head + i].slot = slot;
+		return;
+	}
+
+	/* no write barrier, use the methods of Ink_Array for arrays reachable */
+	inline void set(size_type i, Ink_Object *obj)
+	{
+		if (elem[head + i].slot)
+			elem[head + i].slot->setValue(obj);
+		else
+			elem[head + i].value = obj;
+		return;
+	}
+
+	inline void push(Ink_Object *obj)
+	{
+		elem.push_back(Ink_ArrayElement(obj));
+		return;
+	}
+
+	void unshift(Ink_Object *obj);
+
+	/* slots of the range are not disposed */
+	void erase(size_type begin, size_type end);
+
+	inline void reserve(size_type size)
+	{
+		elem.reserve(head + size);
+		return;
 	}
 };
 
@@ -612,9 +914,18 @@ public:
 		Ink_ArrayMethodInit(engine);
 	}
 	void Ink_ArrayMethodInit(Ink_InterpreteEngine *engine);
+
+	/* obj can be NULL to push a hole */
+	void pushElement(Ink_Object *obj);
+	void setElement(Ink_ArrayValue::size_type i, Ink_Object *obj);
+	/* slot of the element, created if it's still packed(a hole gets undefined) */
+	Ink_HashTable *getElementSlot(Ink_ArrayValue::size_type i);
+	void unshiftElement(Ink_Object *obj);
+	/* remove elements in [begin, end) */
+	void removeElement(Ink_ArrayValue::size_type begin, Ink_ArrayValue::size_type end);
 	
-	static Ink_ArrayValue cloneArrayValue(Ink_ArrayValue val, Ink_Object *parent);
-	static Ink_ArrayValue cloneDeepArrayValue(Ink_InterpreteEngine *engine, Ink_ArrayValue val, Ink_Object *parent);
+	static Ink_ArrayValue cloneArrayValue(Ink_ArrayValue &val);
+	static Ink_ArrayValue cloneDeepArrayValue(Ink_InterpreteEngine *engine, Ink_ArrayValue &val);
 
 	virtual Ink_Object *clone(Ink_InterpreteEngine *engine);
 	virtual Ink_Object *cloneDeep(Ink_InterpreteEngine *engine);
@@ -623,16 +934,7 @@ public:
 		return true;
 	}
 
-	static void disposeArrayValue(Ink_ArrayValue val)
-	{
-		Ink_ArrayValue::size_type i;
-		for (i = 0; i < val.size(); i++) {
-			if (val[i])
-				delete val[i];
-		}
-		return;
-	}
-
+	void disposeSlot(Ink_HashTable *slot);
 	void disposeArrayValue();
 
 	virtual void doSelfMark(Ink_InterpreteEngine *engine, IGC_Marker marker);
@@ -1,5 +1,6 @@
 #include <string.h>
 #include "hash.h"
+#include "symbol.h"
 #include "object.h"
 #include "interface/engine.h"
 #include "native/native.h"
@@ -34,87 +35,164 @@ Ink_Object *Ink_Object::getProto()
 	return ret ? ret->getValue() : NULL;
 }
 
-Ink_HashTable *Ink_Object::getSlotMapping(Ink_InterpreteEngine *engine, const char *key, bool *is_from_proto, bool search_prototype)
+Ink_HashTable *Ink_Object::findSlot(const char *key, const char *sym)
 {
 	Ink_HashTable *i;
-	Ink_HashTable *ret = NULL;
-	Ink_Object *proto = getProto();
-
-	if (!strcmp(key, "prototype")) {
-		ret = getProtoHash();
-		if (is_from_proto) *is_from_proto = false;
-		return ret && ret->getValue() ? ret : NULL;
-	}
 
-	for (i = hash_table; i; i = i->next) {
-		if (!strcmp(i->key, key)) {
+	for (i = hash_index ? hash_index->find(key, sym) : hash_table; i; i = i->next) {
+		if (i->isKey(key, sym)) {
 			if (i->getSetter() || i->getGetter()) {
-				if (is_from_proto) *is_from_proto = false;
 				return i;
 			} else if(i->getValue() || i->getBonding()) {
-				ret = traceHashBond(i);
-				if (is_from_proto) *is_from_proto = false;
-				return ret;
+				return traceHashBond(i);
 			}
 		}
+		/* the indexed node is the only one with this key */
+		if (hash_index && !hash_index->has_dup_key) break;
 	}
 
-	if (!search_prototype) {
-		if (is_from_proto) *is_from_proto = false;
+	return NULL;
+}
+
+Ink_HashTable *Ink_Object::getSlotMapping(Ink_InterpreteEngine *engine, const char *key, bool *is_from_proto, bool search_prototype)
+{
+	Ink_HashTable *ret = NULL;
+	Ink_Object *proto, *tortoise;
+	Ink_SizeType steps, power;
+	const char *sym;
+
+	if (is_from_proto) *is_from_proto = false;
+
+	if (!strcmp(key, "prototype")) {
+		ret = getProtoHash();
+		return ret && ret->getValue() ? ret : NULL;
+	}
+
+	/* look the key up once for the whole prototype chain */
+	sym = InkSymbol_find(key);
+
+	if ((ret = findSlot(key, sym)) != NULL || !search_prototype || !engine) {
 		return ret;
 	}
 
-	if (engine && proto && proto->type != INK_UNDEFINED) {
-		if (!engine->addPrototypeTrace(this)) {
+	/* Brent's cycle detection: the tortoise jumps to the current object
+	 * every 2^n steps, so no visited set is needed */
+	tortoise = this;
+	steps = 0;
+	power = 1;
+	for (proto = getProto(); proto && proto->type != INK_UNDEFINED; proto = proto->getProto()) {
+		if (proto == tortoise) {
 			InkWarn_Circular_Prototype_Reference(engine);
-			engine->initPrototypeSearch();
 			return NULL;
 		}
 
-		ret = proto->getSlotMapping(engine, key);
-		
-		if (ret) {
+		if ((ret = proto->findSlot(key, sym)) != NULL) {
 			if (is_from_proto) *is_from_proto = true;
-			engine->initPrototypeSearch();
 			return ret;
 		}
+
+		if (++steps == power) {
+			tortoise = proto;
+			power <<= 1;
+			steps = 0;
+		}
 	}
 
-	engine->initPrototypeSearch();
-	return ret;
+	return NULL;
 }
 
-Ink_HashTable *Ink_Object::setSlot(const char *key, Ink_Object *value, bool if_check_exist, bool if_alloc_key)
+Ink_HashTable *Ink_Object::findLastSlot(const char *key, const char *sym, bool if_check_exist, Ink_HashTable **last)
 {
-	Ink_HashTable *i, *slot = NULL, *last = NULL;
-
-	if (!strcmp(key, "prototype")) {
-		setProto(value);
-		return proto_hash;
+	Ink_HashTable *i, *slot = NULL;
+
+	if (hash_index) {
+		if (if_check_exist && (i = hash_index->find(key, sym)) != NULL) {
+			if (hash_index->has_dup_key) {
+				for (; i; i = i->next) {
+					if (i->isKey(key, sym)) {
+						slot = traceHashBond(i);
+					}
+				}
+			} else {
+				slot = traceHashBond(i);
+			}
+		}
+		*last = hash_index->end;
+		return slot;
 	}
-	
+
+	*last = NULL;
 	for (i = hash_table; i; i = i->next) {
 		if (if_check_exist) {
-			if (!strcmp(i->key, key)) {
+			if (i->isKey(key, sym)) {
 				slot = traceHashBond(i);
 			}
 		}
-		last = i;
+		*last = i;
 	}
 
+	return slot;
+}
+
+void Ink_Object::appendSlot(Ink_HashTable *slot, Ink_HashTable *last)
+{
+	Ink_HashTable *i;
+	Ink_SizeType count = 0;
+
+	if (hash_table)
+		last->next = slot;
+	else
+		hash_table = slot;
+
+	if (type == INK_CONTEXT) {
+		if (engine && !strcmp(slot->key, "missing"))
+			engine->has_context_missing = true;
+		static_cast<Ink_ContextObject *>(this)->registerFrameSlot(slot);
+	}
+
+	if (hash_index) {
+		hash_index->append(slot);
+		return;
+	}
+
+	for (i = hash_table; i; i = i->next) {
+		if (++count > INK_HASH_INDEX_THRESHOLD) {
+			hash_index = new Ink_HashIndex(hash_table);
+			break;
+		}
+	}
+
+	return;
+}
+
+Ink_HashTable *Ink_Object::setSlot(const char *key, Ink_Object *value, bool if_check_exist, bool if_alloc_key)
+{
+	Ink_HashTable *slot, *last;
+	const char *sym;
+	string *key_p;
+
+	if (!strcmp(key, "prototype")) {
+		setProto(value);
+		return proto_hash;
+	}
+	
+	/* keys passed in without copying live as long as the code, so they can be interned */
+	sym = if_alloc_key ? InkSymbol_find(key) : InkSymbol_intern(key);
+	slot = findLastSlot(key, sym, if_check_exist, &last);
+
 	if (slot) {
 		slot->setValue(value);
 	} else {
-		if (if_alloc_key) {
-			string *key_p = new string(key);
-			slot = new Ink_HashTable(key_p->c_str(), value, this, key_p);
+		if (sym) {
+			slot = new Ink_HashTable(sym, value, this);
+			slot->is_key_interned = true;
 		} else {
-			slot = new Ink_HashTable(key, value, this);
+			/* runtime keys are not interned, the slot owns its copy */
+			key_p = new string(key);
+			slot = new Ink_HashTable(key_p->c_str(), value, this, key_p);
 		}
-		if (hash_table)
-			last->next = slot;
-		else
-			hash_table = slot;
+		appendSlot(slot, last);
+		if (value) Ink_updateSlotEpoch(this);
 	}
 
 	IGC_CHECK_WRITE_BARRIER(this, value);
@@ -124,30 +202,27 @@ Ink_HashTable *Ink_Object::setSlot(const char *key, Ink_Object *value, bool if_c
 
 Ink_HashTable *Ink_Object::setSlot(const char *key, Ink_InterpreteEngine *engine, Ink_Constant *value, bool if_check_exist, bool if_alloc_key)
 {
-	Ink_HashTable *i, *slot = NULL, *last = NULL;
+	Ink_HashTable *slot, *last;
+	const char *sym;
+	string *key_p;
 	
-	for (i = hash_table; i; i = i->next) {
-		if (if_check_exist) {
-			if (!strcmp(i->key, key)) {
-				slot = traceHashBond(i);
-			}
-		}
-		last = i;
-	}
+	/* keys passed in without copying live as long as the code, so they can be interned */
+	sym = if_alloc_key ? InkSymbol_find(key) : InkSymbol_intern(key);
+	slot = findLastSlot(key, sym, if_check_exist, &last);
 
 	if (slot) {
 		slot->setValue(engine, value);
 	} else {
-		if (if_alloc_key) {
-			string *key_p = new string(key);
-			slot = new Ink_HashTable(key_p->c_str(), engine, value, this, key_p);
+		if (sym) {
+			slot = new Ink_HashTable(sym, engine, value, this);
+			slot->is_key_interned = true;
 		} else {
-			slot = new Ink_HashTable(key, engine, value, this);
+			/* runtime keys are not interned, the slot owns its copy */
+			key_p = new string(key);
+			slot = new Ink_HashTable(key_p->c_str(), engine, value, this, key_p);
 		}
-		if (hash_table)
-			last->next = slot;
-		else
-			hash_table = slot;
+		appendSlot(slot, last);
+		if (value) Ink_updateSlotEpoch(this);
 	}
 
 	return slot;
@@ -156,9 +231,10 @@ Ink_HashTable *Ink_Object::setSlot(const char *key, Ink_InterpreteEngine *engine
 void Ink_Object::deleteSlot(const char *key)
 {
 	Ink_HashTable *i;
+	const char *sym = InkSymbol_find(key);
 
-	for (i = hash_table; i; i = i->next) {
-		if (!strcmp(i->key, key)) {
+	for (i = hash_index ? hash_index->find(key, sym) : hash_table; i; i = i->next) {
+		if (i->isKey(key, sym)) {
 			i->setValue(NULL);
 			return;
 		}
@@ -171,6 +247,8 @@ void Ink_Object::cleanHashTable()
 {
 	Ink_Object *obj;
 
+	Ink_updateSlotEpoch(this);
+
 	if (proto_hash) {
 		if ((obj = engine->getGlobalReturnValue()) != NULL
 			&& obj->address == proto_hash) {
@@ -181,9 +259,17 @@ void Ink_Object::cleanHashTable()
 		proto_hash = NULL;
 	}
 
+	if (hash_index) {
+		delete hash_index;
+		hash_index = NULL;
+	}
+
 	cleanHashTable(hash_table);
 	hash_table = NULL;
 
+	if (type == INK_CONTEXT)
+		static_cast<Ink_ContextObject *>(this)->resetFrameSlot();
+
 	return;
 }
 
@@ -0,0 +1,113 @@
+#include <string.h>
+#include <stdlib.h>
+#include <pthread.h>
+#include "symbol.h"
+#include "hash.h"
+
+#define INK_SYMBOL_TABLE_INIT_SIZE 1024
+
+namespace ink {
+
+class InkSymbol_Table {
+public:
+	struct Entry {
+		Ink_UInt32 hash;
+		const char *str;
+	};
+
+	Entry *entry;
+	Ink_SizeType capacity; /* always a power of 2 */
+	Ink_SizeType count;
+
+	/* replaced tables are kept, readers may still be probing them */
+	InkSymbol_Table *retired;
+
+	InkSymbol_Table(Ink_SizeType capacity, InkSymbol_Table *retired)
+	: entry((Entry *)calloc(capacity, sizeof(Entry))), capacity(capacity), count(0), retired(retired)
+	{ }
+
+	const char *find(const char *str, Ink_UInt32 hash)
+	{
+		const char *tmp;
+		Ink_SizeType i;
+
+		for (i = hash & (capacity - 1); (tmp = __atomic_load_n(&entry[i].str, __ATOMIC_ACQUIRE)) != NULL;
+			 i = (i + 1) & (capacity - 1)) {
+			if (entry[i].hash == hash && (tmp == str || !strcmp(tmp, str)))
+				return tmp;
+		}
+
+		return NULL;
+	}
+
+	void insert(const char *str, Ink_UInt32 hash)
+	{
+		Ink_SizeType i;
+
+		for (i = hash & (capacity - 1); entry[i].str; i = (i + 1) & (capacity - 1)) ;
+
+		entry[i].hash = hash;
+		/* publish the string after its hash */
+		__atomic_store_n(&entry[i].str, str, __ATOMIC_RELEASE);
+		count++;
+
+		return;
+	}
+};
+
+static InkSymbol_Table *ink_symbol_table = NULL;
+static pthread_mutex_t ink_symbol_table_lock = PTHREAD_MUTEX_INITIALIZER;
+
+static InkSymbol_Table *InkSymbol_growTable(InkSymbol_Table *table)
+{
+	InkSymbol_Table *ret;
+	Ink_SizeType i;
+
+	if (!table)
+		return new InkSymbol_Table(INK_SYMBOL_TABLE_INIT_SIZE, NULL);
+
+	ret = new InkSymbol_Table(table->capacity * 2, table);
+	for (i = 0; i < table->capacity; i++) {
+		if (table->entry[i].str)
+			ret->insert(table->entry[i].str, table->entry[i].hash);
+	}
+
+	return ret;
+}
+
+const char *InkSymbol_find(const char *str)
+{
+	InkSymbol_Table *table = __atomic_load_n(&ink_symbol_table, __ATOMIC_ACQUIRE);
+
+	return table ? table->find(str, Ink_HashIndex::hashKey(str)) : NULL;
+}
+
+const char *InkSymbol_intern(const char *str)
+{
+	Ink_UInt32 hash = Ink_HashIndex::hashKey(str);
+	InkSymbol_Table *table = __atomic_load_n(&ink_symbol_table, __ATOMIC_ACQUIRE);
+	const char *ret;
+
+	/* lookups never lock, only new symbols do */
+	if (table && (ret = table->find(str, hash)) != NULL)
+		return ret;
+
+	pthread_mutex_lock(&ink_symbol_table_lock);
+
+	table = ink_symbol_table;
+	if (!table || (ret = table->find(str, hash)) == NULL) {
+		/* keep the load factor under 1/2 */
+		if (!table || (table->count + 1) * 2 > table->capacity) {
+			table = InkSymbol_growTable(table);
+			__atomic_store_n(&ink_symbol_table, table, __ATOMIC_RELEASE);
+		}
+		ret = strdup(str);
+		table->insert(ret, hash);
+	}
+
+	pthread_mutex_unlock(&ink_symbol_table_lock);
+
+	return ret;
+}
+
+}
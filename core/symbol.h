@@ -0,0 +1,17 @@
+#ifndef _SYMBOL_H_
+#define _SYMBOL_H_
+
+#include <string.h>
+
+namespace ink {
+
+/* return the process-wide copy of str, equal strings always get the same address
+ * interned strings live until the process exits, so only names known at parse time are interned */
+const char *InkSymbol_intern(const char *str);
+
+/* same as InkSymbol_intern, but return NULL instead of adding str if it's not interned yet */
+const char *InkSymbol_find(const char *str);
+
+}
+
+#endif
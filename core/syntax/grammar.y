@@ -10,21 +10,28 @@
 	#include "core/general.h"
 	#include "core/interface/engine.h"
 	#include "core/interface/setting.h"
-	#define SET_LINE_NO(exp) (exp->line_number = InkParser_getCurrentLineno())
+	#define PARSE_STATE (InkParser_getState(scanner))
+	#define SET_LINE_NO(exp) (exp->line_number = PARSE_STATE->current_line_number)
 	#define YYERROR_VERBOSE 1
 	#define YYDEBUG 1
 
 	using namespace ink;
 
-	extern int yylex();
-	void yyerror(const char *msg) {
-		const char *tmp = InkParser_getParseEngine()->getFilePath();
+	union YYSTYPE;
+	extern int yylex(union YYSTYPE *yylval_param, void *scanner);
+	void yyerror(void *scanner, const char *msg) {
+		InkParser_State *state = InkParser_getState(scanner);
+		const char *tmp = state->engine->getFilePath();
 		fprintf(stderr, "%s: %sline %ld: %s\n", tmp ? tmp : "<unknown input>",
-				InkParser_getErrPrefix(), InkParser_getCurrentLineno(), msg);
+				state->err_prefix, state->current_line_number, msg);
 	}
 
 %}
 
+%define api.pure
+%lex-param { void *scanner }
+%parse-param { void *scanner }
+
 %union {
 	ink::Ink_Expression					*expression;
 	ink::Ink_ParamList					*parameter;
@@ -235,7 +242,7 @@
 parse_unit
 	: top_level_expression_list_opt
 	{
-		InkParser_getParseEngine()->top_level = *$1;
+		PARSE_STATE->engine->top_level = *$1;
 		delete $1;
 	}
 	;
@@ -289,10 +296,10 @@ top_level_expression_list
 	{
 		$$ = new Ink_ExpressionList();
 		$$->push_back($1);
-		if (InkParser_getParseEngine()->getFilePath()) {
+		if (PARSE_STATE->engine->getFilePath()) {
 			$1->file_name
 			= ($1->file_name_p
-			   = new string(InkParser_getParseEngine()->getFilePath()))->c_str();
+			   = new string(PARSE_STATE->engine->getFilePath()))->c_str();
 		}
 	}
 	| top_level_expression_list split expression
@@ -320,10 +327,10 @@ expression_list
 	{
 		$$ = new Ink_ExpressionList();
 		$$->push_back($1);
-		if (InkParser_getParseEngine()->getFilePath()) {
+		if (PARSE_STATE->engine->getFilePath()) {
 			$1->file_name
 			= ($1->file_name_p
-			   = new string(InkParser_getParseEngine()->getFilePath()))->c_str();
+			   = new string(PARSE_STATE->engine->getFilePath()))->c_str();
 		}
 	}
 	| expression_list split expression
@@ -394,7 +401,7 @@ interrupt_signal_ext
 		else {
 			stringstream strm;
 			strm << "Unknown interrupt signal '" << $1->c_str() << "'";
-			yyerror(strm.str().c_str());
+			yyerror(scanner, strm.str().c_str());
 			delete $1;
 			return 0;
 		}
@@ -475,6 +482,8 @@ assignment_expression
 	| logical_or_expression TARR nllo assignment_expression
 	{
 		Ink_ArgumentList arg = Ink_ArgumentList();
+		/* the bondee is bonded by its slot */
+		Ink_setAddressed($4);
 		arg.push_back(new Ink_Argument($4));
 
 		$$ = new Ink_CallExpression(new Ink_HashExpression($1, new string("->")), arg);
@@ -1550,7 +1559,7 @@ single_element_expression
 		delete $1;
 
 		if (!$$) {
-			yyerror("Failed to parse integer");
+			yyerror(scanner, "Failed to parse integer");
 			return -1;
 		}
 
@@ -1562,7 +1571,7 @@ single_element_expression
 		delete $1;
 
 		if (!$$) {
-			yyerror("Failed to parse float");
+			yyerror(scanner, "Failed to parse float");
 			return -1;
 		}
 
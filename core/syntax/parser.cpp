@@ -1,31 +1,30 @@
 #include "syntax.h"
 #include "../interface/engine.h"
 
-static ink::Ink_InterpreteEngine *ink_parse_engine = NULL;
-static pthread_mutex_t ink_parse_lock = PTHREAD_MUTEX_INITIALIZER;
-
 namespace ink {
 
-Ink_InterpreteEngine *InkParser_getParseEngine()
+InkParser_State::InkParser_State(Ink_InterpreteEngine *engine)
+: engine(engine)
 {
-	return ink_parse_engine;
-}
+	input_file = NULL;
+	input_string = NULL;
+	current_source_line = 0;
+	current_char_index = 0;
 
-void InkParser_setParseEngine(Ink_InterpreteEngine *engine)
-{
-	ink_parse_engine = engine;
-	return;
-}
+	current_line_number = engine->parse_line_number;
+	err_prefix = engine->parse_err_prefix;
 
-void InkParser_lockParseLock()
-{
-	pthread_mutex_lock(&ink_parse_lock);
-	return;
+	id_literal = NULL;
+	string_literal = NULL;
+	if_ignore_nl = false;
+
+	scanner = NULL;
 }
 
-void InkParser_unlockParseLock()
+void InkParser_setParserInfo(Ink_InterpreteEngine *engine, Ink_LineNoType lineno, const char *yyprefix)
 {
-	pthread_mutex_unlock(&ink_parse_lock);
+	engine->parse_line_number = lineno;
+	engine->parse_err_prefix = yyprefix;
 	return;
 }
 
@@ -1,20 +1,40 @@
 #ifndef _SYNTAX_H_
 #define _SYNTAX_H_
 
+#include <stdio.h>
+#include <string>
 #include "../general.h"
 
 namespace ink {
 
 class Ink_InterpreteEngine;
 
-void InkParser_setParserInfo(Ink_LineNoType lineno, const char *yyprefix);
-Ink_LineNoType InkParser_getCurrentLineno();
-const char *InkParser_getErrPrefix();
+/* state of a single parse, shared by the reentrant lexer & parser */
+class InkParser_State {
+public:
+	Ink_InterpreteEngine *engine;
 
-Ink_InterpreteEngine *InkParser_getParseEngine();
-void InkParser_setParseEngine(Ink_InterpreteEngine *engine);
-void InkParser_unlockParseLock();
-void InkParser_lockParseLock();
+	/* input is read from input_file, or from input_string(NULL-terminated lines) if set */
+	FILE *input_file;
+	const char **input_string;
+	int current_source_line;
+	int current_char_index;
+
+	Ink_LineNoType current_line_number;
+	const char *err_prefix;
+
+	std::string *id_literal;
+	std::string *string_literal;
+	bool if_ignore_nl;
+
+	void *scanner;
+
+	InkParser_State(Ink_InterpreteEngine *engine);
+};
+
+void InkParser_setParserInfo(Ink_InterpreteEngine *engine, Ink_LineNoType lineno, const char *yyprefix);
+InkParser_State *InkParser_getState(void *scanner);
+int InkParser_parse(InkParser_State *state);
 
 }
 
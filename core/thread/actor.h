@@ -2,7 +2,6 @@
 #define _ACTOR_H_
 
 #include <string>
-#include <queue>
 #include <map>
 #include "thread.h"
 #include "../general.h"
@@ -43,9 +42,10 @@ public:
 	std::string *msg;
 	std::string *sender;
 	Ink_ExceptionRaw *ex;
+	Ink_ActorMessage *next;
 
 	Ink_ActorMessage(std::string *msg, std::string *sender, Ink_ExceptionRaw *ex = NULL)
-	: msg(msg), sender(sender), ex(ex)
+	: msg(msg), sender(sender), ex(ex), next(NULL)
 	{ }
 	
 	~Ink_ActorMessage()
@@ -56,7 +56,78 @@ public:
 	}
 };
 
-typedef std::queue<Ink_ActorMessage *> Ink_ActorMessageQueue;
+/* multi-producer/single-consumer mailbox
+ * senders push onto a lock-free stack, the owner takes the whole stack at once
+ * and reverses it into its private pending list */
+class Ink_ActorMailbox {
+	Ink_ActorMessage *incoming;
+	Ink_ActorMessage *pending;
+
+	void drain()
+	{
+		Ink_ActorMessage *batch = __atomic_exchange_n(&incoming, (Ink_ActorMessage *)NULL,
+													  __ATOMIC_ACQUIRE);
+		Ink_ActorMessage *tmp;
+
+		while (batch) {
+			tmp = batch->next;
+			batch->next = pending;
+			pending = batch;
+			batch = tmp;
+		}
+
+		return;
+	}
+
+public:
+	Ink_ActorMailbox()
+	: incoming(NULL), pending(NULL)
+	{ }
+
+	/* may be called by any thread */
+	void push(Ink_ActorMessage *msg)
+	{
+		Ink_ActorMessage *head = __atomic_load_n(&incoming, __ATOMIC_RELAXED);
+
+		do {
+			msg->next = head;
+		} while (!__atomic_compare_exchange_n(&incoming, &head, msg, true,
+											  __ATOMIC_RELEASE, __ATOMIC_RELAXED));
+
+		return;
+	}
+
+	/* owner only */
+	Ink_ActorMessage *pop()
+	{
+		Ink_ActorMessage *ret;
+
+		if (!pending) drain();
+		if ((ret = pending) != NULL) {
+			pending = ret->next;
+			ret->next = NULL;
+		}
+
+		return ret;
+	}
+
+	void clear()
+	{
+		Ink_ActorMessage *tmp;
+
+		while ((tmp = pop()) != NULL) {
+			delete tmp;
+		}
+
+		return;
+	}
+
+	~Ink_ActorMailbox()
+	{
+		clear();
+	}
+};
+
 typedef std::vector<std::string> Ink_ActorWatcherList;
 
 void InkActor_lockThreadCreateLock();
@@ -38,8 +38,8 @@ Ink_Object *InkMod_Blueprint_Base_If(Ink_InterpreteEngine *engine, Ink_ContextCh
 							if (as<Ink_String>(argv[i])->getValue() == "if") {
 								if (++i < argc) {
 									if (argv[i]->type == INK_ARRAY) {
-										if (as<Ink_Array>(argv[i])->value.size() && as<Ink_Array>(argv[i])->value[0]) {
-											if (isTrue(as<Ink_Array>(argv[i])->value[0]->getValue())) {
+										if (as<Ink_Array>(argv[i])->value.size() && as<Ink_Array>(argv[i])->value.get(0)) {
+											if (isTrue(as<Ink_Array>(argv[i])->value.get(0))) {
 												if (++i < argc) {
 													if (argv[i]->type == INK_FUNCTION) {
 														ret = argv[i]->call(engine, context);
@@ -208,7 +208,7 @@ Ink_Object *InkMod_Blueprint_Base_Try(Ink_InterpreteEngine *engine, Ink_ContextC
 
 	for (i = 1; i < argc; i++) {
 		if (argv[i]->type == INK_STRING) {
-			if (as<Ink_String>(argv[i])->getWValue() == L"catch") {
+			if (as<Ink_String>(argv[i])->getValue() == "catch") {
 				if (i + 1 < argc) {
 					if (argv[i + 1]->type == INK_FUNCTION) {
 						catch_block = argv[i + 1];
@@ -219,7 +219,7 @@ Ink_Object *InkMod_Blueprint_Base_Try(Ink_InterpreteEngine *engine, Ink_ContextC
 					InkWarn_Blueprint_Try_No_Argument_Follwing_Catch(engine);
 				}
 				i++;
-			} else if (as<Ink_String>(argv[i])->getWValue() == L"final") {
+			} else if (as<Ink_String>(argv[i])->getValue() == "final") {
 				if (i + 1 < argc) {
 					if (argv[i + 1]->type == INK_FUNCTION) {
 						final_block = argv[i + 1];
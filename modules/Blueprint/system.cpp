@@ -139,6 +139,23 @@ Ink_Object *InkMod_Blueprint_System_Command(Ink_InterpreteEngine *engine, Ink_Co
 	return new Ink_Numeric(engine, system(cmd.c_str()));
 }
 
+Ink_Object *InkMod_Blueprint_System_AllocCount(Ink_InterpreteEngine *engine, Ink_ContextChain *context, Ink_Object *base, Ink_ArgcType argc, Ink_Object **argv, Ink_Object *this_p)
+{
+	return new Ink_Numeric(engine, engine->igc_alloc_count);
+}
+
+Ink_Object *InkMod_Blueprint_System_SlotPoolStat(Ink_InterpreteEngine *engine, Ink_ContextChain *context, Ink_Object *base, Ink_ArgcType argc, Ink_Object **argv, Ink_Object *this_p)
+{
+	IGC_AllocStat stat = IGC_getAllocStat(IGC_POOL_SLOT);
+	Ink_Object *ret = new Ink_Object(engine);
+
+	ret->setSlot_c("alloc_count", new Ink_Numeric(engine, stat.alloc_count));
+	ret->setSlot_c("reuse_count", new Ink_Numeric(engine, stat.reuse_count));
+	ret->setSlot_c("free_count", new Ink_Numeric(engine, stat.free_count));
+
+	return ret;
+}
+
 void InkMod_Blueprint_System_Path_bondTo(Ink_InterpreteEngine *engine, Ink_Object *bondee)
 {
 	bondee->setSlot_c("sep", new Ink_String(engine, INK_PATH_SPLIT));
@@ -165,6 +182,8 @@ void InkMod_Blueprint_System_bondTo(Ink_InterpreteEngine *engine, Ink_Object *bo
 	bondee->setSlot_c("setenv", new Ink_FunctionObject(engine, InkMod_Blueprint_System_SetEnv));
 	bondee->setSlot_c("getenv", new Ink_FunctionObject(engine, InkMod_Blueprint_System_GetEnv));
 	bondee->setSlot_c("cmd", new Ink_FunctionObject(engine, InkMod_Blueprint_System_Command));
+	bondee->setSlot_c("alloc_count", new Ink_FunctionObject(engine, InkMod_Blueprint_System_AllocCount));
+	bondee->setSlot_c("slot_pool_stat", new Ink_FunctionObject(engine, InkMod_Blueprint_System_SlotPoolStat));
 	bondee->setSlot_c("linesep", new Ink_String(engine, INK_LINE_SEP));
 
 	Ink_Object *path_pkg = addPackage(engine, bondee, "path",
@@ -62,7 +62,6 @@ string *JSON_stringifyObject(Ink_InterpreteEngine *engine, vector<Ink_Object *>
 
 	string ret = "", *tmp_str;
 	Ink_Array *tmp_arr;
-	Ink_ArrayValue tmp_arr_val;
 	Ink_HashTable *hash_i;
 	string::size_type i;
 
@@ -71,10 +70,9 @@ string *JSON_stringifyObject(Ink_InterpreteEngine *engine, vector<Ink_Object *>
 	switch (obj->type) {
 		case INK_ARRAY: {
 			tmp_arr = as<Ink_Array>(obj);
-			tmp_arr_val = tmp_arr->value;
 			ret += "[";
-			for (i = 0; i < tmp_arr_val.size(); i++) {
-				if ((tmp_str = JSON_stringifyObject(engine, trace, tmp_arr_val[i]->getValue())) != NULL) {
+			for (i = 0; i < tmp_arr->value.size(); i++) {
+				if ((tmp_str = JSON_stringifyObject(engine, trace, tmp_arr->value.get(i))) != NULL) {
 					if (ret != "[") ret += ", ";
 					ret += *tmp_str;
 					delete tmp_str;
@@ -133,6 +131,7 @@ void InkMod_JSON_bondTo(Ink_InterpreteEngine *engine, Ink_Object *bondee)
 {
 	bondee->setSlot_c("encode", new Ink_FunctionObject(engine, InkNative_JSON_Encode));
 	bondee->setSlot_c("decode", new Ink_FunctionObject(engine, InkNative_JSON_Decode));
+	bondee->setSlot_c("Stream", new Ink_FunctionObject(engine, InkNative_JSON_Stream_Constructor));
 
 	return;
 }
@@ -146,6 +145,7 @@ Ink_Object *InkMod_JSON_Loader(Ink_InterpreteEngine *engine, Ink_ContextChain *c
 	Ink_Object *apply_to = argv[1];
 	Ink_Object *json_pkg = addPackage(engine, apply_to, "json", new Ink_FunctionObject(engine, InkMod_JSON_Loader));
 
+	InkMod_JSON_bondStreamType(engine, context);
 	InkMod_JSON_bondTo(engine, json_pkg);
 
 	return NULL_OBJ;
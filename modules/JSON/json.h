@@ -4,16 +4,65 @@
 #include "core/object.h"
 #include "core/error.h"
 #include "core/interface/engine.h"
+#include "parser.h"
+
+#define JSON_STREAM_TYPE (getJSONStreamType(engine))
 
 using namespace ink;
 
+struct com_cleaner_arg {
+	Ink_ModuleID id;
+	com_cleaner_arg(Ink_ModuleID id)
+	: id(id)
+	{ }
+};
+
+struct com_struct {
+	Ink_TypeTag stream_type;
+
+	com_struct()
+	: stream_type(-1)
+	{ }
+};
+
+Ink_TypeTag getJSONStreamType(Ink_InterpreteEngine *engine);
+void InkMod_JSON_bondStreamType(Ink_InterpreteEngine *engine, Ink_ContextChain *context);
+
 Ink_Object *InkNative_JSON_Encode(Ink_InterpreteEngine *engine, Ink_ContextChain *context, Ink_Object *base, Ink_ArgcType argc, Ink_Object **argv, Ink_Object *this_p);
 Ink_Object *InkNative_JSON_Decode(Ink_InterpreteEngine *engine, Ink_ContextChain *context, Ink_Object *base, Ink_ArgcType argc, Ink_Object **argv, Ink_Object *this_p);
+Ink_Object *InkNative_JSON_Stream_Constructor(Ink_InterpreteEngine *engine, Ink_ContextChain *context, Ink_Object *base, Ink_ArgcType argc, Ink_Object **argv, Ink_Object *this_p);
+
+/* incremental parser, calls the handler slot with (event, value) for each event */
+class Ink_JSONStream: public Ink_Object {
+public:
+	InkJSON_StreamParser *parser;
+
+	Ink_JSONStream(Ink_InterpreteEngine *engine)
+	: Ink_Object(engine), parser(new InkJSON_StreamParser())
+	{
+		type = JSON_STREAM_TYPE;
+		initProto(engine);
+	}
+
+	virtual void derivedMethodInit(Ink_InterpreteEngine *engine)
+	{
+		Ink_JSONStreamMethodInit(engine);
+	}
+	void Ink_JSONStreamMethodInit(Ink_InterpreteEngine *engine);
+
+	virtual ~Ink_JSONStream()
+	{
+		delete parser;
+	}
+};
 
 extern Ink_ModuleID ink_native_json_mod_id;
 
 enum InkMod_JSON_ExceptionCode {
-	INK_EXCODE_WARN_JSON_CYCLIC_REFERENCE = INK_EXCODE_CUSTOM_START
+	INK_EXCODE_WARN_JSON_CYCLIC_REFERENCE = INK_EXCODE_CUSTOM_START,
+	INK_EXCODE_WARN_JSON_SYNTAX_ERROR,
+	INK_EXCODE_WARN_JSON_STREAM_FAILED,
+	INK_EXCODE_WARN_JSON_STREAM_REENTERED
 };
 
 inline void
@@ -25,4 +74,31 @@ InkWarn_JSON_Cyclic_Reference(Ink_InterpreteEngine *engine)
 	return;
 }
 
+inline void
+InkWarn_JSON_Syntax_Error(Ink_InterpreteEngine *engine, const char *offset, const char *msg)
+{
+	InkErro_doPrintWarning(engine, ink_native_json_mod_id,
+						   INK_EXCODE_WARN_JSON_SYNTAX_ERROR,
+						   "Syntax error at offset $(offset): $(msg)", offset, msg);
+	return;
+}
+
+inline void
+InkWarn_JSON_Stream_Failed(Ink_InterpreteEngine *engine)
+{
+	InkErro_doPrintWarning(engine, ink_native_json_mod_id,
+						   INK_EXCODE_WARN_JSON_STREAM_FAILED,
+						   "Feeding a failed stream, reset it first");
+	return;
+}
+
+inline void
+InkWarn_JSON_Stream_Reentered(Ink_InterpreteEngine *engine)
+{
+	InkErro_doPrintWarning(engine, ink_native_json_mod_id,
+						   INK_EXCODE_WARN_JSON_STREAM_REENTERED,
+						   "Feeding or resetting a stream from its own handler");
+	return;
+}
+
 #endif
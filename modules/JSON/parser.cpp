@@ -1,11 +1,12 @@
 #include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
 #include "json.h"
 #include "parser.h"
 #include "core/object.h"
 #include "core/general.h"
 #include "core/error.h"
 #include "core/native/native.h"
-#include "core/expression.h"
 #include "core/interface/engine.h"
 
 using namespace ink;
@@ -20,326 +21,606 @@ struct token_name_map_tmp_t {
 	{ "right bracket" },
 	{ "colon" },
 	{ "comma" },
-	{ "quote mark" },
 	{ "string" },
 	{ "numeric" },
-	{ "null" }
+	{ "true" },
+	{ "false" },
+	{ "null" },
+	{ "ending" }
 };
 
-InkJSON_TokenStack
-JSON_lexer(string str)
+const char *InkJSON_getTokenName(InkJSON_Token_tag token)
 {
-	InkJSON_TokenStack ret = InkJSON_TokenStack();
-	string::size_type i;
-	InkJSON_LexState state = JLS_NORMAL;
-	string string_literal = "";
-	string numeric_literal = "";
-	InkJSON_Value tmp_val;
-	
-	tmp_val.str = NULL;
-	tmp_val.num = 0;
-
-	for (i = 0; i < str.length(); i++) {
-		switch (str[i]) {
-			case '{':
-				switch (state) {
-					case JLS_NORMAL:
-						tmp_val.str = NULL;
-						ret.push_back(InkJSON_Token(JT_LBRACE, tmp_val));
-						break;
-					case JLS_IN_STRING:
-						string_literal += "{";
-				}
-				break;
-			case '}':
-				switch (state) {
-					case JLS_NORMAL:
-						tmp_val.str = NULL;
-						ret.push_back(InkJSON_Token(JT_RBRACE, tmp_val));
-						break;
-					case JLS_IN_STRING:
-						string_literal += "}";
-				}
-				break;
-			case '[':
-				switch (state) {
-					case JLS_NORMAL:
-						tmp_val.str = NULL;
-						ret.push_back(InkJSON_Token(JT_LBRACKET, tmp_val));
-						break;
-					case JLS_IN_STRING:
-						string_literal += "[";
-				}
-				break;
-			case ']':
-				switch (state) {
-					case JLS_NORMAL:
-						tmp_val.str = NULL;
-						ret.push_back(InkJSON_Token(JT_RBRACKET, tmp_val));
-						break;
-					case JLS_IN_STRING:
-						string_literal += "]";
-				}
-				break;
-			case ':':
-				switch (state) {
-					case JLS_NORMAL:
-						tmp_val.str = NULL;
-						ret.push_back(InkJSON_Token(JT_COLON, tmp_val));
-						break;
-					case JLS_IN_STRING:
-						string_literal += ":";
-				}
-				break;
-			case ',':
-				switch (state) {
-					case JLS_NORMAL:
-						tmp_val.str = NULL;
-						ret.push_back(InkJSON_Token(JT_COMMA, tmp_val));
-						break;
-					case JLS_IN_STRING:
-						string_literal += ",";
-				}
-				break;
-			case '"':
-				switch (state) {
-					case JLS_NORMAL:
-						state = JLS_IN_STRING;
-						string_literal = "";
-						break;
-					case JLS_IN_STRING:
-						state = JLS_NORMAL;
-						tmp_val.str = new string(string_literal);
-						ret.push_back(InkJSON_Token(JT_STRING, tmp_val));
-						break;
-				}
-				break;
-			case '\\':
-				switch (state) {
-					case JLS_NORMAL:
-						break;
-					case JLS_IN_STRING:
-						if (i + 1 < str.length()) {
-							switch (str[i + 1]) {
-								case '"':
-									string_literal += "\"";
-									break;
-								case 't':
-									string_literal += "\t";
-									break;
-								case '\\':
-									string_literal += "\\";
-									break;
-								default:
-									i--;
-							}
-							i++;
-						} else {
-							fprintf(stderr, "JSON Lex: Unexpected token '\\', ignore\n");
-						}
-						break;
-				}
-				break;
-			case '-':
-			case '0':
-			case '1':
-			case '2':
-			case '3':
-			case '4':
-			case '5':
-			case '6':
-			case '7':
-			case '8':
-			case '9': {
-				if (state == JLS_IN_STRING) {
-					string_literal += str.substr(i, 1);
-					break;
-				}
-				numeric_literal = str.substr(i, 1);
-				string::size_type j;
-				bool is_success;
-				double val;
-
-				for (j = i + 1; j < str.length()
-							&& ((str[j] >= '0'
-							&& str[j] <= '9') || str[j] == '.'); j++) {
-					numeric_literal += str.substr(j, 1);
-				}
-				i = j - 1;
-
-				val = getFloat(Ink_NumericExpression::parseFloat(numeric_literal, false, &is_success));
-				if (is_success) {
-					tmp_val.num = val;
-					ret.push_back(InkJSON_Token(JT_NUMERIC, tmp_val));
-				} else {
-					fprintf(stderr, "JSON Lex: Failed to parse numeric '%s'", numeric_literal.c_str());
+	return token_name_map[token].name;
+}
+
+inline bool isJSONSpace(char c)
+{
+	return c == ' ' || c == '\t' || c == '\n' || c == '\r';
+}
+
+inline bool isJSONDigit(char c)
+{
+	return c >= '0' && c <= '9';
+}
+
+inline int hexValue(char c)
+{
+	if (c >= '0' && c <= '9') return c - '0';
+	if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+	if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+	return -1;
+}
+
+inline bool readHex4(const char *p, unsigned int &code)
+{
+	int i, tmp;
+
+	code = 0;
+	for (i = 0; i < 4; i++) {
+		if ((tmp = hexValue(p[i])) < 0)
+			return false;
+		code = (code << 4) | tmp;
+	}
+
+	return true;
+}
+
+inline void appendUTF8(string &str, unsigned int code)
+{
+	if (code < 0x80) {
+		str += (char)code;
+	} else if (code < 0x800) {
+		str += (char)(0xC0 | (code >> 6));
+		str += (char)(0x80 | (code & 0x3F));
+	} else if (code < 0x10000) {
+		str += (char)(0xE0 | (code >> 12));
+		str += (char)(0x80 | ((code >> 6) & 0x3F));
+		str += (char)(0x80 | (code & 0x3F));
+	} else {
+		str += (char)(0xF0 | (code >> 18));
+		str += (char)(0x80 | ((code >> 12) & 0x3F));
+		str += (char)(0x80 | ((code >> 6) & 0x3F));
+		str += (char)(0x80 | (code & 0x3F));
+	}
+	return;
+}
+
+const char *InkJSON_scanString(const char *p, const char *end, const char *&resume)
+{
+	for (; p < end; p++) {
+		if (*p == '"') return p;
+		if (*p == '\\') {
+			if (p + 1 >= end) break;
+			p++;
+		}
+	}
+	resume = p;
+
+	return NULL;
+}
+
+/* p: after the opening quote, quote: the closing quote */
+static bool decodeString(const char *p, const char *quote, string &str, const char *&err)
+{
+	const char *seg;
+	unsigned int code, low;
+
+	str.clear();
+	while (p < quote) {
+		for (seg = p; p < quote && *p != '\\'; p++) ;
+		str.append(seg, p - seg);
+		if (p >= quote) break;
+
+		/* escape */
+		switch (p[1]) {
+			case '"': str += '"'; break;
+			case '\\': str += '\\'; break;
+			case '/': str += '/'; break;
+			case 'b': str += '\b'; break;
+			case 'f': str += '\f'; break;
+			case 'n': str += '\n'; break;
+			case 'r': str += '\r'; break;
+			case 't': str += '\t'; break;
+			case 'u':
+				if (quote - p < 6 || !readHex4(p + 2, code)) {
+					err = "invalid unicode escape";
+					return false;
 				}
-				break;
-			}
-			case '\n':
-			case ' ':
-			case '\t':
-				if (state == JLS_IN_STRING) {
-					string_literal += str.substr(i, 1);
-					break;
+				if (code >= 0xD800 && code <= 0xDBFF) {
+					/* surrogate pair */
+					if (quote - p < 12 || p[6] != '\\' || p[7] != 'u'
+						|| !readHex4(p + 8, low) || low < 0xDC00 || low > 0xDFFF) {
+						err = "invalid surrogate pair";
+						return false;
+					}
+					code = 0x10000 + ((code - 0xD800) << 10) + (low - 0xDC00);
+					p += 6;
 				}
+				appendUTF8(str, code);
+				p += 4;
 				break;
-			case 'n':
-			case 't':
-			case 'f':
-				if (state == JLS_IN_STRING) {
-					string_literal += str.substr(i, 1);
-					break;
-				}
-				if (i + 3 < str.length() && str.substr(i, 4) == "null") {
-					i += 3;
-					ret.push_back(InkJSON_Token(JT_NULL, tmp_val));
-					break;
-				} else if (i + 3 < str.length() && str.substr(i, 4) == "true") {
-					i += 3;
-					tmp_val.num = 1;
-					ret.push_back(InkJSON_Token(JT_NUMERIC, tmp_val));
-					break;
-				} else if (i + 4 < str.length() && str.substr(i, 5) == "false") {
-					i += 4;
-					tmp_val.num = 0;
-					ret.push_back(InkJSON_Token(JT_NUMERIC, tmp_val));
-					break;
-				}
-				// fallthrough
 			default:
-				switch (state) {
-					case JLS_NORMAL:
-						fprintf(stderr, "JSON Lex: Unexpected token '%c', ignore\n", str[i]);
-						break;
-					case JLS_IN_STRING:
-						string_literal += str.substr(i, 1);
-						break;
-				}
+				err = "invalid escape";
+				return false;
 		}
+		p += 2;
 	}
 
-	return ret;
+	return true;
 }
 
-JSON_ParserReturnVal
-JSON_parser(Ink_InterpreteEngine *engine, InkJSON_TokenStack token_stack,
-			InkJSON_TokenStack::size_type start_index = 0)
+static InkJSON_LexResult lexNumeric(const char *&cur, const char *end, bool is_final,
+									InkJSON_Token &tok, const char *&err)
 {
-	Ink_Object *ret = NULL;
-	JSON_ParserReturnVal tmp_ret;
-	InkJSON_ParseStateStack state_stack = InkJSON_ParseStateStack();
-	InkJSON_TokenStack::size_type i = start_index, j;
-	Ink_ArrayValue arr_val;
-	string *tmp_str;
-	Ink_Array *arr_obj;
-
-	switch (token_stack[i].token) {
-		case JT_LBRACE: {
-			ret = new Ink_Object(engine);
-			if (token_stack[i + 1].token == JT_RBRACE) {
-				return JSON_ParserReturnVal(ret, i + 1);
-			}
-			for (j = i + 1;
-				 j + 3 < token_stack.size();) {
-				if (token_stack[j].token == JT_STRING
-					&& token_stack[j + 1].token == JT_COLON) {
-					tmp_str = token_stack[j].value.str;
-					tmp_ret = JSON_parser(engine, token_stack, j + 2);
-					j = tmp_ret.end_index;
-
-					if (tmp_ret.ret) {
-						ret->setSlot(tmp_str->c_str(), tmp_ret.ret);
-						if (token_stack[tmp_ret.end_index + 1].token == JT_RBRACE) {
-							return JSON_ParserReturnVal(ret, j + 1);
-						} else if (token_stack[tmp_ret.end_index + 1].token == JT_COMMA) {
-							j += 2;
-							continue;
-						}
-					} else {
-						return JSON_ParserReturnVal(NULL, j);
-					}
-				} else {
-					fprintf(stderr, "Unexpected %s and %s, expecting string constant\n",
-							token_name_map[token_stack[j].token].name,
-							token_name_map[token_stack[j + 1].token].name);
-					return JSON_ParserReturnVal(NULL, j);
-				}
-			}
-			fprintf(stderr, "Unexpected ending, expecting brace\n");
-			return JSON_ParserReturnVal(NULL, i);
+	const char *p = cur;
+	char buffer[64];
+	string tmp_str;
+
+	if (p < end && *p == '-') p++;
+	if (p < end && *p == '0') {
+		p++;
+	} else if (p < end && isJSONDigit(*p)) {
+		while (p < end && isJSONDigit(*p)) p++;
+	} else if (p < end) {
+		err = "invalid numeric";
+		return JLR_ERROR;
+	}
+
+	if (p < end && *p == '.') {
+		p++;
+		if (p < end && !isJSONDigit(*p)) {
+			err = "invalid numeric";
+			return JLR_ERROR;
 		}
-		case JT_LBRACKET: {
-			arr_obj = new Ink_Array(engine);
-			if (token_stack[i + 1].token == JT_RBRACKET) {
-				return JSON_ParserReturnVal(arr_obj, i + 1);
+		while (p < end && isJSONDigit(*p)) p++;
+	}
+
+	if (p < end && (*p == 'e' || *p == 'E')) {
+		p++;
+		if (p < end && (*p == '+' || *p == '-')) p++;
+		if (p < end && !isJSONDigit(*p)) {
+			err = "invalid numeric";
+			return JLR_ERROR;
+		}
+		while (p < end && isJSONDigit(*p)) p++;
+	}
+
+	if (p == end && !is_final) {
+		return JLR_INCOMPLETE;
+	}
+
+	if (!isJSONDigit(p[-1])) {
+		err = "invalid numeric";
+		return JLR_ERROR;
+	}
+
+	/* strtod needs a terminated copy, the input may continue with digits of other tokens */
+	if ((Ink_SizeType)(p - cur) < sizeof(buffer)) {
+		memcpy(buffer, cur, p - cur);
+		buffer[p - cur] = '\0';
+		tok.num = strtod(buffer, NULL);
+	} else {
+		tmp_str = string(cur, p - cur);
+		tok.num = strtod(tmp_str.c_str(), NULL);
+	}
+	tok.token = JT_NUMERIC;
+	cur = p;
+
+	return JLR_OK;
+}
+
+static InkJSON_LexResult lexLiteral(const char *&cur, const char *end, bool is_final,
+									const char *literal, InkJSON_Token_tag token,
+									InkJSON_Token &tok, const char *&err)
+{
+	Ink_SizeType len = strlen(literal);
+	Ink_SizeType avail = end - cur;
+
+	if (avail < len) {
+		if (!strncmp(cur, literal, avail) && !is_final)
+			return JLR_INCOMPLETE;
+		err = "invalid literal";
+		return JLR_ERROR;
+	}
+
+	if (strncmp(cur, literal, len)) {
+		err = "invalid literal";
+		return JLR_ERROR;
+	}
+
+	tok.token = token;
+	cur += len;
+
+	return JLR_OK;
+}
+
+InkJSON_LexResult InkJSON_lex(const char *&cur, const char *end, bool is_final,
+							  InkJSON_Token &tok, const char *&err)
+{
+	const char *quote, *resume;
+
+	while (cur < end && isJSONSpace(*cur)) cur++;
+
+	if (cur == end) {
+		if (!is_final) return JLR_INCOMPLETE;
+		tok.token = JT_END;
+		return JLR_OK;
+	}
+
+	switch (*cur) {
+		case '{': tok.token = JT_LBRACE; break;
+		case '}': tok.token = JT_RBRACE; break;
+		case '[': tok.token = JT_LBRACKET; break;
+		case ']': tok.token = JT_RBRACKET; break;
+		case ':': tok.token = JT_COLON; break;
+		case ',': tok.token = JT_COMMA; break;
+		case '"':
+			if (!(quote = InkJSON_scanString(cur + 1, end, resume))) {
+				if (!is_final) return JLR_INCOMPLETE;
+				err = "unterminated string";
+				return JLR_ERROR;
 			}
-			for (j = i + 1;
-				 j + 1 < token_stack.size();) {
-				tmp_ret = JSON_parser(engine, token_stack, j);
-				j = tmp_ret.end_index;
-
-				if (tmp_ret.ret) {
-					arr_obj->value.push_back(new Ink_HashTable(tmp_ret.ret, arr_obj));
-					if (token_stack[tmp_ret.end_index + 1].token == JT_RBRACKET) {
-						return JSON_ParserReturnVal(arr_obj, j + 1);
-					} else if (token_stack[tmp_ret.end_index + 1].token == JT_COMMA) {
-						j += 2;
-						continue;
-					} else {
-						fprintf(stderr, "Unexpected %s, expecting comma or bracket\n",
-								token_name_map[token_stack[j + 1].token].name);
-						return JSON_ParserReturnVal(NULL, j);
-					}
-				} else {
-					return JSON_ParserReturnVal(NULL, j);
-				}
+			if (!decodeString(cur + 1, quote, tok.str, err)) {
+				return JLR_ERROR;
 			}
-			fprintf(stderr, "Unexpected ending, expecting bracket\n");
-			return JSON_ParserReturnVal(NULL, i);
-		}
+			tok.token = JT_STRING;
+			cur = quote + 1;
+			return JLR_OK;
+		case 't':
+			return lexLiteral(cur, end, is_final, "true", JT_TRUE, tok, err);
+		case 'f':
+			return lexLiteral(cur, end, is_final, "false", JT_FALSE, tok, err);
+		case 'n':
+			return lexLiteral(cur, end, is_final, "null", JT_NULL, tok, err);
+		default:
+			if (*cur == '-' || isJSONDigit(*cur)) {
+				return lexNumeric(cur, end, is_final, tok, err);
+			}
+			err = "unexpected character";
+			return JLR_ERROR;
+	}
+	cur++;
+
+	return JLR_OK;
+}
+
+bool InkJSON_Parser::next()
+{
+	const char *err = NULL;
+
+	if (failed) return false;
+	if (InkJSON_lex(cur, end, true, tok, err) != JLR_OK) {
+		error(err);
+		return false;
+	}
+
+	return true;
+}
+
+void InkJSON_Parser::error(const char *msg)
+{
+	char offset[32];
+
+	if (failed) return;
+	failed = true;
+
+	sprintf(offset, "%lu", (unsigned long)(cur - begin));
+	InkWarn_JSON_Syntax_Error(engine, offset, msg);
+
+	return;
+}
+
+void InkJSON_Parser::unexpected(const char *expect)
+{
+	string msg = string("unexpected ") + InkJSON_getTokenName(tok.token)
+				 + ", expecting " + expect;
+	error(msg.c_str());
+	return;
+}
+
+/* the first token of the value has been read */
+Ink_Object *InkJSON_Parser::parseValue()
+{
+	switch (tok.token) {
+		case JT_LBRACE:
+			return parseObject();
+		case JT_LBRACKET:
+			return parseArray();
 		case JT_STRING:
-			return JSON_ParserReturnVal(new Ink_String(engine, *token_stack[i].value.str), i);
+			return new Ink_String(engine, tok.str);
 		case JT_NUMERIC:
-			return JSON_ParserReturnVal(new Ink_Numeric(engine, token_stack[i].value.num), i);
+			return new Ink_Numeric(engine, tok.num);
+		case JT_TRUE:
+			return new Ink_Numeric(engine, 1);
+		case JT_FALSE:
+			return new Ink_Numeric(engine, 0);
 		case JT_NULL:
-			return JSON_ParserReturnVal(NULL_OBJ, i);
-		default: ;
-			//fprintf(stderr, "Unexpected %d, expecting ending\n", token_stack[i].token);
+			return NULL_OBJ;
+		default:
+			unexpected("value");
 	}
 
-	return JSON_ParserReturnVal(NULL, i);
+	return NULL;
 }
 
-void disposeTokenStack(InkJSON_TokenStack stack)
+Ink_Object *InkJSON_Parser::parseObject()
 {
-	InkJSON_TokenStack::iterator iter;
+	Ink_Object *ret, *value;
+	string key;
+
+	if (++depth > INKJSON_MAX_DEPTH) {
+		error("nesting too deep");
+		return NULL;
+	}
+
+	ret = new Ink_Object(engine);
+	if (!next()) return NULL;
+	if (tok.token == JT_RBRACE) {
+		depth--;
+		return ret;
+	}
+
+	while (1) {
+		if (tok.token != JT_STRING) {
+			unexpected("string constant");
+			return NULL;
+		}
+		key = tok.str;
+
+		if (!next()) return NULL;
+		if (tok.token != JT_COLON) {
+			unexpected("colon");
+			return NULL;
+		}
 
-	for (iter = stack.begin(); iter != stack.end(); iter++) {
-		if (iter->token == JT_STRING) {
-			delete iter->value.str;
+		if (!next() || !(value = parseValue())) return NULL;
+		ret->setSlot(key.c_str(), value);
+
+		if (!next()) return NULL;
+		if (tok.token == JT_RBRACE) break;
+		if (tok.token != JT_COMMA) {
+			unexpected("comma or brace");
+			return NULL;
 		}
+		if (!next()) return NULL;
 	}
+	depth--;
+
+	return ret;
 }
 
-Ink_Object *JSON_parse(Ink_InterpreteEngine *engine, string str)
+Ink_Object *InkJSON_Parser::parseArray()
+{
+	Ink_Array *ret;
+	Ink_Object *value;
+
+	if (++depth > INKJSON_MAX_DEPTH) {
+		error("nesting too deep");
+		return NULL;
+	}
+
+	ret = new Ink_Array(engine);
+	if (!next()) return NULL;
+	if (tok.token == JT_RBRACKET) {
+		depth--;
+		return ret;
+	}
+
+	while (1) {
+		if (!(value = parseValue())) return NULL;
+		ret->pushElement(value);
+
+		if (!next()) return NULL;
+		if (tok.token == JT_RBRACKET) break;
+		if (tok.token != JT_COMMA) {
+			unexpected("comma or bracket");
+			return NULL;
+		}
+		if (!next()) return NULL;
+	}
+	depth--;
+
+	return ret;
+}
+
+Ink_Object *InkJSON_Parser::parse()
+{
+	Ink_Object *ret;
+
+	if (!next() || !(ret = parseValue()) || !next()) {
+		return NULL;
+	}
+
+	if (tok.token != JT_END) {
+		unexpected("ending");
+		return NULL;
+	}
+
+	return ret;
+}
+
+bool InkJSON_StreamParser::error(InkJSON_StreamHandler *handler, const char *msg, Ink_SizeType at)
+{
+	failed = true;
+	handler->onError(msg, at);
+	return false;
+}
+
+bool InkJSON_StreamParser::endValue()
 {
-	InkJSON_TokenStack token_stack = JSON_lexer(str);
-	JSON_ParserReturnVal ret_val = JSON_parser(engine, token_stack);
+	state = nest.empty() ? JSS_DONE : JSS_COMMA_OR_END;
+	return true;
+}
 
-	disposeTokenStack(token_stack);
+bool InkJSON_StreamParser::step(InkJSON_StreamHandler *handler, Ink_SizeType at)
+{
+	string msg;
 
-	if (ret_val.end_index + 1 < token_stack.size()) {
-		fprintf(stderr, "Unexpected %s, expecting ending\n",
-				token_name_map[token_stack[ret_val.end_index + 1].token].name);
-		return NULL_OBJ;
+	switch (state) {
+		case JSS_KEY_OR_END:
+			if (tok.token == JT_RBRACE) {
+				nest.pop_back();
+				endValue();
+				return handler->onEvent(JE_END_OBJECT, NULL);
+			}
+			// fallthrough
+		case JSS_KEY:
+			if (tok.token != JT_STRING) {
+				msg = "expecting string constant";
+				break;
+			}
+			state = JSS_COLON;
+			return handler->onEvent(JE_KEY, &tok);
+		case JSS_COLON:
+			if (tok.token != JT_COLON) {
+				msg = "expecting colon";
+				break;
+			}
+			state = JSS_VALUE;
+			return true;
+		case JSS_COMMA_OR_END:
+			if (tok.token == JT_COMMA) {
+				state = nest.back() == '{' ? JSS_KEY : JSS_VALUE;
+				return true;
+			}
+			if (tok.token == (nest.back() == '{' ? JT_RBRACE : JT_RBRACKET)) {
+				nest.pop_back();
+				endValue();
+				return handler->onEvent(tok.token == JT_RBRACE
+										? JE_END_OBJECT : JE_END_ARRAY, NULL);
+			}
+			msg = nest.back() == '{' ? "expecting comma or brace" : "expecting comma or bracket";
+			break;
+		case JSS_VALUE_OR_END:
+			if (tok.token == JT_RBRACKET) {
+				nest.pop_back();
+				endValue();
+				return handler->onEvent(JE_END_ARRAY, NULL);
+			}
+			// fallthrough
+		case JSS_VALUE:
+			switch (tok.token) {
+				case JT_LBRACE:
+				case JT_LBRACKET:
+					if (nest.size() >= INKJSON_MAX_DEPTH) {
+						return error(handler, "nesting too deep", at);
+					}
+					nest.push_back(tok.token == JT_LBRACE ? '{' : '[');
+					state = tok.token == JT_LBRACE ? JSS_KEY_OR_END : JSS_VALUE_OR_END;
+					return handler->onEvent(tok.token == JT_LBRACE
+											? JE_BEGIN_OBJECT : JE_BEGIN_ARRAY, NULL);
+				case JT_STRING:
+				case JT_NUMERIC:
+				case JT_TRUE:
+				case JT_FALSE:
+				case JT_NULL:
+					endValue();
+					return handler->onEvent(JE_VALUE, &tok);
+				default:
+					msg = "expecting value";
+			}
+			break;
+		case JSS_DONE:
+			msg = "expecting ending";
+			break;
 	}
 
-	if (ret_val.ret) {
-		return ret_val.ret;
+	msg = string("unexpected ") + InkJSON_getTokenName(tok.token) + ", " + msg;
+	return error(handler, msg.c_str(), at);
+}
+
+bool InkJSON_StreamParser::feed(InkJSON_StreamHandler *handler, const char *data,
+								Ink_SizeType len, bool is_final)
+{
+	const char *begin, *cur, *end, *token_begin, *consumed, *resume;
+	const char *err = NULL;
+	InkJSON_LexResult res;
+	bool ret = true;
+
+	if (failed || is_feeding) return false;
+
+	pending.append(data, len);
+	begin = cur = pending.data();
+	end = begin + pending.size();
+
+	/* a long string split into many chunks is only scanned once */
+	if (string_checked) {
+		if (!InkJSON_scanString(begin + string_checked, end, resume)) {
+			if (!is_final) {
+				string_checked = resume - begin;
+				return true;
+			}
+		}
+		string_checked = 0;
 	}
 
-	return NULL_OBJ;
+	consumed = cur;
+	is_feeding = true;
+	while (1) {
+		while (cur < end && isJSONSpace(*cur)) cur++;
+		consumed = token_begin = cur;
+
+		if ((res = InkJSON_lex(cur, end, is_final, tok, err)) == JLR_INCOMPLETE) {
+			/* keep the incomplete token for the next chunk */
+			if (*token_begin == '"') {
+				InkJSON_scanString(token_begin + 1, end, resume);
+				string_checked = resume - token_begin;
+			}
+			break;
+		}
+
+		if (res == JLR_ERROR) {
+			ret = error(handler, err, offset + (token_begin - begin));
+			break;
+		}
+		consumed = cur;
+
+		if (tok.token == JT_END) {
+			if (state != JSS_DONE) {
+				ret = error(handler, "unexpected ending", offset + (token_begin - begin));
+			}
+			break;
+		}
+
+		if (!step(handler, offset + (token_begin - begin))) {
+			ret = false;
+			break;
+		}
+	}
+
+	is_feeding = false;
+	offset += consumed - begin;
+	pending.erase(0, consumed - begin);
+
+	return ret;
+}
+
+bool InkJSON_StreamParser::finish(InkJSON_StreamHandler *handler)
+{
+	return feed(handler, "", 0, true);
+}
+
+void InkJSON_StreamParser::reset()
+{
+	if (is_feeding) return;
+
+	pending.clear();
+	string_checked = 0;
+	offset = 0;
+	nest.clear();
+	state = JSS_VALUE;
+	failed = false;
+
+	return;
+}
+
+Ink_Object *JSON_parse(Ink_InterpreteEngine *engine, string str)
+{
+	InkJSON_Parser parser = InkJSON_Parser(engine, str.data(), str.data() + str.length());
+	Ink_Object *ret = parser.parse();
+
+	return ret ? ret : NULL_OBJ;
 }
 
 Ink_Object *InkNative_JSON_Decode(Ink_InterpreteEngine *engine, Ink_ContextChain *context, Ink_Object *base, Ink_ArgcType argc, Ink_Object **argv, Ink_Object *this_p)
@@ -3,7 +3,9 @@
 
 #include <string>
 #include <vector>
-#include <stack>
+#include "core/object.h"
+
+#define INKJSON_MAX_DEPTH (4096)
 
 using namespace ink;
 using namespace std;
@@ -15,49 +17,138 @@ enum InkJSON_Token_tag {
 	JT_RBRACKET,
 	JT_COLON,
 	JT_COMMA,
-	JT_QUOTA,
 	JT_STRING,
 	JT_NUMERIC,
-	JT_NULL
-};
-enum InkJSON_LexState {
-	JLS_NORMAL,
-	JLS_IN_STRING
+	JT_TRUE,
+	JT_FALSE,
+	JT_NULL,
+	JT_END
 };
-enum InkJSON_ParseState {
-	JPS_START,
-	JPS_IN_HASH_TABLE,
-	JPS_IN_ARRAY,
-	JPS_IN_HASH
-};
-
-class InkJSON_Token;
 
-typedef union InkJSON_Value_tag {
-	string *str;
-	double num;
-} InkJSON_Value;
-typedef vector<InkJSON_Token> InkJSON_TokenStack;
-typedef vector<InkJSON_ParseState> InkJSON_ParseStateStack;
+enum InkJSON_LexResult {
+	JLR_OK,
+	JLR_INCOMPLETE, /* token may continue in the next chunk */
+	JLR_ERROR
+};
 
 class InkJSON_Token {
 public:
 	InkJSON_Token_tag token;
-	InkJSON_Value value;
+	string str;
+	double num;
 
-	InkJSON_Token(InkJSON_Token_tag token, InkJSON_Value value)
-	: token(token), value(value)
+	InkJSON_Token()
+	: token(JT_END), str(""), num(0)
 	{ }
 };
 
-class JSON_ParserReturnVal {
+const char *InkJSON_getTokenName(InkJSON_Token_tag token);
+
+/* scan the closing quote of a string literal from p(after the opening quote)
+ * return: the quote, or NULL with resume set to where the next scan can restart */
+const char *InkJSON_scanString(const char *p, const char *end, const char *&resume);
+
+/* lex one token from [cur, end) and move cur past it
+ * if is_final is false, a token reaching end is reported as incomplete */
+InkJSON_LexResult InkJSON_lex(const char *&cur, const char *end, bool is_final,
+							  InkJSON_Token &tok, const char *&err);
+
+/* single pass recursive descent parser building objects from the buffer */
+class InkJSON_Parser {
+	Ink_InterpreteEngine *engine;
+	const char *begin;
+	const char *cur;
+	const char *end;
+	InkJSON_Token tok;
+	Ink_SizeType depth;
+	bool failed;
+
+	bool next();
+	void error(const char *msg);
+	void unexpected(const char *expect);
+
+	Ink_Object *parseValue();
+	Ink_Object *parseObject();
+	Ink_Object *parseArray();
+
 public:
-	Ink_Object *ret;
-	InkJSON_TokenStack::size_type end_index;
+	InkJSON_Parser(Ink_InterpreteEngine *engine, const char *begin, const char *end)
+	: engine(engine), begin(begin), cur(begin), end(end), tok(InkJSON_Token()),
+	  depth(0), failed(false)
+	{ }
+
+	/* return: NULL if failed */
+	Ink_Object *parse();
+};
 
-	JSON_ParserReturnVal(Ink_Object *ret = NULL, InkJSON_TokenStack::size_type end_index = 0)
-	: ret(ret), end_index(end_index)
+enum InkJSON_Event {
+	JE_BEGIN_OBJECT,
+	JE_END_OBJECT,
+	JE_BEGIN_ARRAY,
+	JE_END_ARRAY,
+	JE_KEY,
+	JE_VALUE
+};
+
+class InkJSON_StreamHandler {
+public:
+	/* tok is set for JE_KEY & JE_VALUE, return false to stop parsing */
+	virtual bool onEvent(InkJSON_Event event, InkJSON_Token *tok) = 0;
+	virtual void onError(const char *msg, Ink_SizeType offset) = 0;
+	virtual ~InkJSON_StreamHandler() { }
+};
+
+enum InkJSON_StreamState {
+	JSS_VALUE,
+	JSS_VALUE_OR_END,
+	JSS_KEY,
+	JSS_KEY_OR_END,
+	JSS_COLON,
+	JSS_COMMA_OR_END,
+	JSS_DONE
+};
+
+/* push parser, input can be split at any byte */
+class InkJSON_StreamParser {
+	string pending;
+	Ink_SizeType string_checked; /* bytes of pending known to be inside a string */
+	Ink_SizeType offset; /* offset of pending in the whole input */
+	vector<char> nest;
+	InkJSON_StreamState state;
+	InkJSON_Token tok;
+	bool failed;
+	bool is_feeding; /* pending is being parsed, it can't change under the handler */
+
+	bool error(InkJSON_StreamHandler *handler, const char *msg, Ink_SizeType at);
+	bool endValue();
+	bool step(InkJSON_StreamHandler *handler, Ink_SizeType at);
+
+public:
+	InkJSON_StreamParser()
+	: pending(""), string_checked(0), offset(0), nest(vector<char>()),
+	  state(JSS_VALUE), tok(InkJSON_Token()), failed(false), is_feeding(false)
 	{ }
+
+	/* return: false if failed or stopped */
+	bool feed(InkJSON_StreamHandler *handler, const char *data, Ink_SizeType len, bool is_final = false);
+	bool finish(InkJSON_StreamHandler *handler);
+
+	inline bool isDone()
+	{
+		return state == JSS_DONE;
+	}
+
+	inline bool isFailed()
+	{
+		return failed;
+	}
+
+	inline bool isFeeding()
+	{
+		return is_feeding;
+	}
+
+	void reset();
 };
 
 #endif
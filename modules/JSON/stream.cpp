@@ -0,0 +1,194 @@
+#include <stdio.h>
+#include "json.h"
+#include "parser.h"
+#include "core/object.h"
+#include "core/general.h"
+#include "core/native/native.h"
+#include "core/interface/engine.h"
+
+using namespace ink;
+
+static const char *event_name_map[] = {
+	"begin_object",
+	"end_object",
+	"begin_array",
+	"end_array",
+	"key",
+	"value"
+};
+
+class InkJSON_ObjectHandler: public InkJSON_StreamHandler {
+	Ink_InterpreteEngine *engine;
+	Ink_ContextChain *context;
+	Ink_Object *handler;
+
+public:
+	InkJSON_ObjectHandler(Ink_InterpreteEngine *engine, Ink_ContextChain *context, Ink_Object *handler)
+	: engine(engine), context(context), handler(handler)
+	{ }
+
+	virtual bool onEvent(InkJSON_Event event, InkJSON_Token *tok)
+	{
+		Ink_Object *argv[2];
+
+		argv[0] = new Ink_String(engine, event_name_map[event]);
+		argv[1] = UNDEFINED;
+
+		if (tok) {
+			switch (tok->token) {
+				case JT_STRING:
+					argv[1] = new Ink_String(engine, tok->str);
+					break;
+				case JT_NUMERIC:
+					argv[1] = new Ink_Numeric(engine, tok->num);
+					break;
+				case JT_TRUE:
+					argv[1] = new Ink_Numeric(engine, 1);
+					break;
+				case JT_FALSE:
+					argv[1] = new Ink_Numeric(engine, 0);
+					break;
+				case JT_NULL:
+					argv[1] = NULL_OBJ;
+					break;
+				default: ;
+			}
+		}
+
+		handler->call(engine, context, 2, argv);
+
+		/* stop if the handler throws or exits */
+		return engine->getSignal() == INTER_NONE;
+	}
+
+	virtual void onError(const char *msg, Ink_SizeType offset)
+	{
+		char buffer[32];
+
+		sprintf(buffer, "%lu", (unsigned long)offset);
+		InkWarn_JSON_Syntax_Error(engine, buffer, msg);
+
+		return;
+	}
+};
+
+Ink_TypeTag getJSONStreamType(Ink_InterpreteEngine *engine)
+{
+	return engine->getEngineComAs<com_struct>(ink_native_json_mod_id)->stream_type;
+}
+
+Ink_Object *InkNative_JSON_Stream_Constructor(Ink_InterpreteEngine *engine, Ink_ContextChain *context, Ink_Object *base, Ink_ArgcType argc, Ink_Object **argv, Ink_Object *this_p)
+{
+	Ink_Object *ret;
+
+	if (!checkArgument(engine, argc, argv, 1, INK_FUNCTION)) {
+		return NULL_OBJ;
+	}
+
+	context->getLocal()->setSlot_c("this", ret = new Ink_JSONStream(engine));
+	ret->setSlot_c("handler", argv[0]);
+
+	return ret;
+}
+
+static Ink_Object *InkJSON_Stream_doFeed(Ink_InterpreteEngine *engine, Ink_ContextChain *context,
+										 Ink_Object *base, const string &data, bool is_final)
+{
+	InkJSON_StreamParser *parser;
+	Ink_Object *handler;
+
+	ASSUME_BASE_TYPE(engine, JSON_STREAM_TYPE);
+
+	parser = as<Ink_JSONStream>(base)->parser;
+	if (parser->isFeeding()) {
+		InkWarn_JSON_Stream_Reentered(engine);
+		return NULL_OBJ;
+	}
+	if (parser->isFailed()) {
+		InkWarn_JSON_Stream_Failed(engine);
+		return NULL_OBJ;
+	}
+
+	handler = base->getSlot(engine, "handler");
+	if (handler->type != INK_FUNCTION) {
+		InkWarn_Wrong_Argument_Type(engine, INK_FUNCTION, handler->type);
+		return NULL_OBJ;
+	}
+
+	InkJSON_ObjectHandler tmp_handler = InkJSON_ObjectHandler(engine, context, handler);
+	if (!parser->feed(&tmp_handler, data.data(), data.length(), is_final)) {
+		return NULL_OBJ;
+	}
+
+	return TRUE_OBJ;
+}
+
+Ink_Object *InkNative_JSON_Stream_Feed(Ink_InterpreteEngine *engine, Ink_ContextChain *context, Ink_Object *base, Ink_ArgcType argc, Ink_Object **argv, Ink_Object *this_p)
+{
+	if (!checkArgument(engine, argc, argv, 1, INK_STRING)) {
+		return NULL_OBJ;
+	}
+
+	return InkJSON_Stream_doFeed(engine, context, base, as<Ink_String>(argv[0])->getValue(), false);
+}
+
+Ink_Object *InkNative_JSON_Stream_Finish(Ink_InterpreteEngine *engine, Ink_ContextChain *context, Ink_Object *base, Ink_ArgcType argc, Ink_Object **argv, Ink_Object *this_p)
+{
+	return InkJSON_Stream_doFeed(engine, context, base,
+								 argc && argv[0]->type == INK_STRING
+								 ? as<Ink_String>(argv[0])->getValue() : "", true);
+}
+
+Ink_Object *InkNative_JSON_Stream_Reset(Ink_InterpreteEngine *engine, Ink_ContextChain *context, Ink_Object *base, Ink_ArgcType argc, Ink_Object **argv, Ink_Object *this_p)
+{
+	ASSUME_BASE_TYPE(engine, JSON_STREAM_TYPE);
+
+	if (as<Ink_JSONStream>(base)->parser->isFeeding()) {
+		InkWarn_JSON_Stream_Reentered(engine);
+		return NULL_OBJ;
+	}
+	as<Ink_JSONStream>(base)->parser->reset();
+
+	return TRUE_OBJ;
+}
+
+void Ink_JSONStream::Ink_JSONStreamMethodInit(Ink_InterpreteEngine *engine)
+{
+	setSlot_c("feed", new Ink_FunctionObject(engine, InkNative_JSON_Stream_Feed));
+	setSlot_c("finish", new Ink_FunctionObject(engine, InkNative_JSON_Stream_Finish));
+	setSlot_c("reset", new Ink_FunctionObject(engine, InkNative_JSON_Stream_Reset));
+
+	return;
+}
+
+void InkMod_JSON_EngineComCleaner(Ink_InterpreteEngine *engine, void *arg)
+{
+	com_cleaner_arg *tmp = (com_cleaner_arg *)arg;
+
+	delete engine->getEngineComAs<com_struct>(tmp->id);
+	delete tmp;
+
+	return;
+}
+
+void InkMod_JSON_bondStreamType(Ink_InterpreteEngine *engine, Ink_ContextChain *context)
+{
+	Ink_Object *tmp;
+	com_struct *com = NULL;
+	Ink_Object *obj_proto = engine->getTypePrototype(INK_OBJECT);
+
+	if (!(com = engine->getEngineComAs<com_struct>(ink_native_json_mod_id))) {
+		com = new com_struct();
+
+		engine->addEngineCom(ink_native_json_mod_id, com);
+		engine->addDestructor(Ink_EngineDestructor(InkMod_JSON_EngineComCleaner, new com_cleaner_arg(ink_native_json_mod_id)));
+	} else if (com->stream_type != (Ink_TypeTag)-1) /* has registered */ return;
+
+	com->stream_type = engine->registerType("json_stream");
+	context->getGlobal()->setSlot_c("$json_stream", tmp = new Ink_JSONStream(engine));
+	engine->setTypePrototype(com->stream_type, tmp);
+	tmp->setProto(obj_proto);
+	tmp->derivedMethodInit(engine);
+
+	return;
+}
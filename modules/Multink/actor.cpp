@@ -73,7 +73,7 @@ Ink_Object *InkNative_Actor_Receive(Ink_InterpreteEngine *engine, Ink_ContextCha
 			if (tmp_instr == "every") {
 				if (argv[i + 1]->type == INK_ARRAY
 					&& (arr_val = as<Ink_Array>(argv[i + 1])->value).size()) {
-					if ((tmp_obj = arr_val[0]->getValue())->type == INK_NUMERIC) {
+					if ((tmp_obj = arr_val.get(0)) && tmp_obj->type == INK_NUMERIC) {
 						delay = getInt(as<Ink_Numeric>(tmp_obj)->getValue());
 						i++;
 					} else {
@@ -87,7 +87,7 @@ Ink_Object *InkNative_Actor_Receive(Ink_InterpreteEngine *engine, Ink_ContextCha
 			} else if (tmp_instr == "for") {
 				if (argv[i + 1]->type == INK_ARRAY
 					&& (arr_val = as<Ink_Array>(argv[i + 1])->value).size()) {
-					if ((tmp_obj = arr_val[0]->getValue())->type == INK_NUMERIC) {
+					if ((tmp_obj = arr_val.get(0)) && tmp_obj->type == INK_NUMERIC) {
 						max_time = getInt(as<Ink_Numeric>(tmp_obj)->getValue());
 						i++;
 					} else {
@@ -267,7 +267,7 @@ void *Ink_ActorFunction_sub(void *arg)
 		var_arg = new Ink_Array(tmp->engine);
 		for (; argi < tmp->argc; argi++) {
 			/* push arguments in to VA array */
-			var_arg->value.push_back(new Ink_HashTable(tmp->argv[argi], var_arg));
+			var_arg->pushElement(tmp->argv[argi]);
 		}
 
 		/* set VA array */